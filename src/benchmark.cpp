@@ -0,0 +1,262 @@
+// Throughput benchmark: runs every engine over a fixed set of boards (the bundled assets, random soups at several
+// densities and scaled-up soups) and reports cell updates per second, nanoseconds per generation and peak RSS as
+// JSON, so builds can be compared before they roll out. Each case runs in a child process of its own where fork() is
+// available, so its peak RSS covers that case alone.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine_config.h"
+#include "png_file.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* const kUsage =
+    "usage: raylib_life_benchmark [options]\n"
+    "  --assets=<dir>                   directory holding the bundled PNG patterns (default: assets)\n"
+    "  --engines=<a,b,...>              engines to run (default: packed,sparse,hashlife)\n"
+    "  --max-size=<cells>               largest scaled soup edge (default: 32768)\n"
+    "  --min-seconds=<s>                minimum timed run per case (default: 0.5)\n"
+    "  --output=<file.json>             write the report to a file instead of stdout\n";
+
+// The unbounded engines track every chunk or quadtree node of a dense soup, which stops being meaningful (and fits in
+// memory poorly) well before the packed engine's largest boards
+constexpr int kLargestUnboundedSoup = 4096;
+
+// A bundled asset, or a size x size random soup
+struct BenchmarkCase {
+  std::string name;
+  bool soup = false;
+  int size = 0;
+  double density = 0;
+};
+
+struct BenchmarkConfig {
+  std::string assets = "assets";
+  std::vector<std::string> engines = {"packed", "sparse", "hashlife"};
+  int maxSize = 32768;
+  double minSeconds = 0.5;
+  std::string output;
+};
+
+uint64_t PeakRssBytes() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+  return counters.PeakWorkingSetSize;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+std::vector<std::string> SplitList(std::string_view list) {
+  std::vector<std::string> items;
+  while (!list.empty()) {
+    const size_t comma = list.find(',');
+    items.emplace_back(list.substr(0, comma));
+    if (comma == std::string_view::npos) break;
+    list.remove_prefix(comma + 1);
+  }
+  return items;
+}
+
+// Boards are built only when their case runs, so no case pays for the memory of the others
+bool LoadCaseBoard(const BenchmarkCase& benchmarkCase, const BenchmarkConfig& config, Board* board,
+                   std::string* error) {
+  if (!benchmarkCase.soup) return LoadPngBoard(config.assets + "/" + benchmarkCase.name + ".png", board, error);
+  *board = RandomBoard(benchmarkCase.size, benchmarkCase.size, benchmarkCase.density, 1);
+  return true;
+}
+
+// Exit codes of a case
+constexpr int kCaseDone = 0;
+constexpr int kCaseFailed = 1;
+constexpr int kCaseSkipped = 2;
+
+// Runs one engine on one case and sets *record to its JSON object
+int RunCase(const BenchmarkCase& benchmarkCase, const std::string& engineName, const EngineConfig& engineConfig,
+            const BenchmarkConfig& config, std::string* record) {
+  std::string error;
+  Board board;
+  if (!LoadCaseBoard(benchmarkCase, config, &board, &error)) {
+    std::fprintf(stderr, "skipping %s: %s\n", benchmarkCase.name.c_str(), error.c_str());
+    return kCaseSkipped;
+  }
+  EngineConfig caseConfig = engineConfig;
+  caseConfig.engine = engineName;
+  std::unique_ptr<Engine> engine = CreateEngine(caseConfig, board, &error);
+  if (engine == nullptr) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return kCaseFailed;
+  }
+
+  // Double the batch until a single timed run lasts long enough to trust
+  uint64_t generations = 1;
+  double seconds = 0;
+  while (true) {
+    const auto start = std::chrono::steady_clock::now();
+    engine->Advance(generations);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (seconds >= config.minSeconds || generations >= (uint64_t{1} << 24)) break;
+    generations *= 2;
+  }
+
+  const double cells = static_cast<double>(board.Width()) * board.Height();
+  const double nsPerGeneration = seconds * 1e9 / static_cast<double>(generations);
+  const double cellUpdatesPerSecond = cells * static_cast<double>(generations) / seconds;
+  char line[512];
+  std::snprintf(line, sizeof(line),
+                "{\"board\": \"%s\", \"width\": %d, \"height\": %d, \"engine\": \"%s\", \"generations\": %llu, "
+                "\"seconds\": %.6f, \"ns_per_generation\": %.1f, \"cell_updates_per_second\": %.1f, "
+                "\"peak_rss_bytes\": %llu}",
+                benchmarkCase.name.c_str(), board.Width(), board.Height(), engine->Name(),
+                static_cast<unsigned long long>(generations), seconds, nsPerGeneration, cellUpdatesPerSecond,
+                static_cast<unsigned long long>(PeakRssBytes()));
+  *record = line;
+  std::fprintf(stderr, "%-16s %-9s %12.0f ns/gen %10.3f Gcell/s\n", benchmarkCase.name.c_str(), engine->Name(),
+               nsPerGeneration, cellUpdatesPerSecond * 1e-9);
+  return kCaseDone;
+}
+
+#if defined(_WIN32)
+// Without fork() the cases share one process, so each peak RSS also covers every case run before it
+int RunIsolatedCase(const BenchmarkCase& benchmarkCase, const std::string& engineName,
+                    const EngineConfig& engineConfig, const BenchmarkConfig& config, std::string* record) {
+  return RunCase(benchmarkCase, engineName, engineConfig, config, record);
+}
+#else
+// Runs the case in a child process, which starts out with only this small process's pages, and reads its record back
+// through a pipe
+int RunIsolatedCase(const BenchmarkCase& benchmarkCase, const std::string& engineName,
+                    const EngineConfig& engineConfig, const BenchmarkConfig& config, std::string* record) {
+  int fds[2];
+  if (pipe(fds) != 0) return RunCase(benchmarkCase, engineName, engineConfig, config, record);
+  std::fflush(stderr);
+  const pid_t pid = fork();
+  if (pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return RunCase(benchmarkCase, engineName, engineConfig, config, record);
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    std::string childRecord;
+    const int status = RunCase(benchmarkCase, engineName, engineConfig, config, &childRecord);
+    for (size_t written = 0; written < childRecord.size();) {
+      const ssize_t count = write(fds[1], childRecord.data() + written, childRecord.size() - written);
+      if (count <= 0) _exit(kCaseFailed);
+      written += static_cast<size_t>(count);
+    }
+    std::fflush(stderr);
+    _exit(status);
+  }
+  close(fds[1]);
+  char buffer[512];
+  ssize_t count;
+  while ((count = read(fds[0], buffer, sizeof(buffer))) > 0) record->append(buffer, static_cast<size_t>(count));
+  close(fds[0]);
+  int status = 0;
+  if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) return kCaseFailed;
+  return WEXITSTATUS(status);
+}
+#endif
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  EngineConfig engineConfig;
+  BenchmarkConfig config;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    std::string error;
+    uint64_t number = 0;
+    if (ParseEngineArgument(arg, &engineConfig, &error)) {
+      // Handled, possibly with an error reported below
+    } else if (arg.starts_with("--assets=")) {
+      config.assets = arg.substr(9);
+    } else if (arg.starts_with("--engines=")) {
+      config.engines = SplitList(arg.substr(10));
+    } else if (arg.starts_with("--max-size=")) {
+      if (!ParseNumber(arg.substr(11), &number) || number == 0 || number > 65536) error = "invalid size";
+      config.maxSize = static_cast<int>(number);
+    } else if (arg.starts_with("--min-seconds=")) {
+      config.minSeconds = std::strtod(std::string(arg.substr(14)).c_str(), nullptr);
+      if (!(config.minSeconds > 0)) error = "invalid duration";
+    } else if (arg.starts_with("--output=")) {
+      config.output = arg.substr(9);
+    } else if (arg == "--help") {
+      std::fprintf(stdout, "%s%s", kUsage, kEngineUsage);
+      return 0;
+    } else {
+      error = "unknown argument";
+    }
+    if (!error.empty()) {
+      std::fprintf(stderr, "%s: %s\n%s%s", argv[i], error.c_str(), kUsage, kEngineUsage);
+      return 1;
+    }
+  }
+
+  std::string error;
+  const StepKernel* kernel = ResolveKernel(engineConfig, &error);
+  if (kernel == nullptr) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  std::vector<BenchmarkCase> cases;
+  for (const char* asset : {"glidergun", "simpletest", "glidergunHD", "simpletestHD"}) cases.push_back({asset});
+  for (const double density : {0.1, 0.3, 0.5}) {
+    cases.push_back({"soup1024_d" + std::to_string(static_cast<int>(density * 100)), true, 1024, density});
+  }
+  for (int size = 4096; size <= config.maxSize; size *= 2) {
+    cases.push_back({"soup" + std::to_string(size) + "_d30", true, size, 0.3});
+  }
+
+  std::string report = "{\n  \"rule\": \"" + ConfigRuleString(engineConfig) + "\",\n  \"kernel\": \"" +
+                       std::string(kernel->name) +
+                       "\",\n  \"threads\": " + std::to_string(engineConfig.packed.threads) + ",\n  \"results\": [";
+  bool first = true;
+  for (const BenchmarkCase& benchmarkCase : cases) {
+    for (const std::string& engineName : config.engines) {
+      if (engineName != "packed" && benchmarkCase.soup && benchmarkCase.size > kLargestUnboundedSoup) continue;
+      std::string record;
+      const int status = RunIsolatedCase(benchmarkCase, engineName, engineConfig, config, &record);
+      if (status == kCaseSkipped) break;
+      if (status != kCaseDone) return 1;
+      report += (first ? "\n    " : ",\n    ") + record;
+      first = false;
+    }
+  }
+  report += "\n  ]\n}\n";
+
+  FILE* out = config.output.empty() ? stdout : std::fopen(config.output.c_str(), "w");
+  if (out == nullptr) {
+    std::fprintf(stderr, "%s: could not open for writing\n", config.output.c_str());
+    return 1;
+  }
+  std::fputs(report.c_str(), out);
+  if (out != stdout) std::fclose(out);
+  return 0;
+}
@@ -0,0 +1,348 @@
+#include "board.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+// SSE2 is part of the x86-64 baseline, so it needs no runtime check
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LIFE_SSE2 1
+#else
+#define LIFE_SSE2 0
+#endif
+
+namespace {
+
+// Fills words [firstWord, ...) of a board row one pixel at a time
+void ThresholdRowScalar(const uint8_t* pixels, int width, int bytesPerPixel, int channel, uint8_t threshold,
+                        int firstWord, uint64_t* out) {
+  for (int word = firstWord; word * Board::kBitsPerWord < width; ++word) {
+    const int begin = word * Board::kBitsPerWord;
+    const int cells = std::min(Board::kBitsPerWord, width - begin);
+    const uint8_t* in = pixels + static_cast<size_t>(begin) * bytesPerPixel + channel;
+    uint64_t bits = 0;
+    for (int i = 0; i < cells; ++i) bits |= uint64_t{in[i * bytesPerPixel] >= threshold} << i;
+    out[word] = bits;
+  }
+}
+
+#if LIFE_SSE2
+// Byte `channel` of 16 consecutive pixels, in pixel order. Loads stay within the 16 pixels.
+template <int kBytesPerPixel>
+inline __m128i ChannelBytes(const uint8_t* pixels, __m128i shift) {
+  const __m128i* in = reinterpret_cast<const __m128i*>(pixels);
+  if constexpr (kBytesPerPixel == 1) {
+    return _mm_loadu_si128(in);
+  } else if constexpr (kBytesPerPixel == 2) {
+    const __m128i low = _mm_set1_epi16(0xff);
+    return _mm_packus_epi16(_mm_and_si128(_mm_srl_epi16(_mm_loadu_si128(in), shift), low),
+                            _mm_and_si128(_mm_srl_epi16(_mm_loadu_si128(in + 1), shift), low));
+  } else {
+    const __m128i low = _mm_set1_epi32(0xff);
+    const auto lane = [&](int i) { return _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(in + i), shift), low); };
+    return _mm_packus_epi16(_mm_packs_epi32(lane(0), lane(1)), _mm_packs_epi32(lane(2), lane(3)));
+  }
+}
+#endif
+
+template <int kBytesPerPixel>
+void ThresholdRow(const uint8_t* pixels, int width, int channel, uint8_t threshold, uint64_t* out) {
+  int word = 0;
+#if LIFE_SSE2
+  const __m128i shift = _mm_cvtsi32_si128(8 * channel);
+  const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+  for (; (word + 1) * Board::kBitsPerWord <= width; ++word) {
+    const uint8_t* in = pixels + static_cast<size_t>(word) * Board::kBitsPerWord * kBytesPerPixel;
+    uint64_t bits = 0;
+    for (int group = 0; group < 4; ++group) {
+      const __m128i bytes = ChannelBytes<kBytesPerPixel>(in + group * 16 * kBytesPerPixel, shift);
+      // Unsigned bytes >= threshold exactly where max(bytes, threshold) == bytes
+      const __m128i alive = _mm_cmpeq_epi8(_mm_max_epu8(bytes, limit), bytes);
+      bits |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(alive))} << (group * 16);
+    }
+    out[word] = bits;
+  }
+#endif
+  ThresholdRowScalar(pixels, width, kBytesPerPixel, channel, threshold, word, out);
+}
+
+#if LIFE_SSE2
+// Luma bytes of 16 RGB pixels (48 bytes), weighted as in BoardFromRgbLuma. Loads stay within the 16 pixels.
+inline __m128i LumaBytes(const uint8_t* pixels) {
+  const __m128i bytePairs = _mm_set1_epi32(0x00ff00ff);
+  const __m128i redBlueWeights = _mm_set1_epi32(29 << 16 | 77);
+  const __m128i greenWeight = _mm_set1_epi32(150);
+  const auto load = [](const uint8_t* at) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(at)); };
+  // Four pixels starting at byte 0 of `v`, each spread to a 32-bit lane with R, G and B in its low bytes. SSE2 has no
+  // byte shuffle, so whole-register byte shifts and 32-bit unpacks do the deinterleaving.
+  const auto luma4 = [&](__m128i v) {
+    const __m128i rgb = _mm_unpacklo_epi64(_mm_unpacklo_epi32(v, _mm_srli_si128(v, 3)),
+                                           _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9)));
+    const __m128i sum = _mm_add_epi32(_mm_madd_epi16(_mm_and_si128(rgb, bytePairs), redBlueWeights),
+                                      _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(rgb, 8), bytePairs), greenWeight));
+    return _mm_srli_epi32(sum, 8);
+  };
+  const __m128i low = _mm_packs_epi32(luma4(load(pixels)), luma4(load(pixels + 12)));
+  const __m128i high = _mm_packs_epi32(luma4(load(pixels + 24)), luma4(_mm_srli_si128(load(pixels + 32), 4)));
+  return _mm_packus_epi16(low, high);
+}
+#endif
+
+// 64 cells of a row starting at `cell`, cell + i in bit i. Cells past the end of the row read as dead.
+inline uint64_t CellsAt(const uint64_t* row, int wordsPerRow, int cell) {
+  const int word = cell / Board::kBitsPerWord;
+  const int shift = cell % Board::kBitsPerWord;
+  uint64_t bits = row[word] >> shift;
+  if (shift != 0 && word + 1 < wordsPerRow) bits |= row[word + 1] << (Board::kBitsPerWord - shift);
+  return bits;
+}
+
+// The low 8 bits as 8 bytes of 0x00 or 0xff, bit i in byte i
+inline uint64_t ExpandBits8(uint64_t bits) {
+  // Byte i keeps only bit i of its copy; adding 0x7f then sets the top bit of exactly the nonzero bytes
+  const uint64_t spread = (bits * 0x0101010101010101ull) & 0x8040201008040201ull;
+  return (((spread + 0x7f7f7f7f7f7f7f7full) & 0x8080808080808080ull) >> 7) * 0xff;
+}
+
+#if LIFE_SSE2
+// The low 16 bits as 16 bytes of 0x00 or 0xff, bit i in byte i
+inline __m128i ExpandBits16(uint32_t bits) {
+  const __m128i select = _mm_set1_epi64x(static_cast<int64_t>(0x8040201008040201ull));
+  const __m128i copies = _mm_set_epi64x(static_cast<int64_t>(((bits >> 8) & 0xff) * 0x0101010101010101ull),
+                                        static_cast<int64_t>((bits & 0xff) * 0x0101010101010101ull));
+  return _mm_cmpeq_epi8(_mm_and_si128(copies, select), select);
+}
+#endif
+
+}  // namespace
+
+Board::Board(int width, int height)
+    : width_(width),
+      height_(height),
+      wordsPerRow_((width + kBitsPerWord - 1) / kBitsPerWord),
+      tailMask_(width % kBitsPerWord == 0 ? ~uint64_t{0} : (uint64_t{1} << (width % kBitsPerWord)) - 1),
+      words_(static_cast<size_t>(wordsPerRow_) * height, 0) {}
+
+void Board::Clear() { std::fill(words_.begin(), words_.end(), 0); }
+
+size_t Board::Population() const {
+  size_t population = 0;
+  for (const uint64_t word : words_) population += std::popcount(word);
+  return population;
+}
+
+Board BoardFromChannel(const uint8_t* pixels, int width, int height, int bytesPerPixel, int channel,
+                       uint8_t threshold) {
+  Board board(width, height);
+  const size_t rowBytes = static_cast<size_t>(width) * bytesPerPixel;
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = pixels + y * rowBytes;
+    uint64_t* row = board.Row(y);
+    switch (bytesPerPixel) {
+      case 1:
+        ThresholdRow<1>(in, width, channel, threshold, row);
+        break;
+      case 2:
+        ThresholdRow<2>(in, width, channel, threshold, row);
+        break;
+      case 4:
+        ThresholdRow<4>(in, width, channel, threshold, row);
+        break;
+      default:
+        ThresholdRowScalar(in, width, bytesPerPixel, channel, threshold, 0, row);
+    }
+  }
+  return board;
+}
+
+Board BoardFromRgba(const uint8_t* pixels, int width, int height) {
+  return BoardFromChannel(pixels, width, height, 4, 3, 1);
+}
+
+Board BoardFromRgbLuma(const uint8_t* pixels, int width, int height, uint8_t threshold) {
+  Board board(width, height);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = pixels + static_cast<size_t>(y) * width * 3;
+    uint64_t* row = board.Row(y);
+    int x = 0;
+#if LIFE_SSE2
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    for (; x + Board::kBitsPerWord <= width; x += Board::kBitsPerWord) {
+      uint64_t bits = 0;
+      for (int group = 0; group < 4; ++group) {
+        const __m128i luma = LumaBytes(in + static_cast<size_t>(x + group * 16) * 3);
+        const __m128i alive = _mm_cmpeq_epi8(_mm_max_epu8(luma, limit), luma);
+        bits |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(alive))} << (group * 16);
+      }
+      row[x / Board::kBitsPerWord] = bits;
+    }
+#endif
+    for (; x < width; ++x) {
+      // Weights in 1/256ths, as stb_image uses for its own grayscale conversion
+      const int luma = (in[x * 3] * 77 + in[x * 3 + 1] * 150 + in[x * 3 + 2] * 29) >> 8;
+      if (luma >= threshold) row[x / Board::kBitsPerWord] |= uint64_t{1} << (x % Board::kBitsPerWord);
+    }
+  }
+  return board;
+}
+
+void BoardToGrayscale(const Board& board, int x, int y, int width, int height, uint8_t* out) {
+  for (int row = 0; row < height; ++row) {
+    const uint64_t* words = board.Row(y + row);
+    uint8_t* pixels = out + static_cast<size_t>(row) * width;
+    for (int column = 0; column < width; column += Board::kBitsPerWord) {
+      const uint64_t bits = CellsAt(words, board.WordsPerRow(), x + column);
+      const int cells = std::min(Board::kBitsPerWord, width - column);
+      int cell = 0;
+#if LIFE_SSE2
+      for (; cell + 16 <= cells; cell += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + column + cell),
+                         ExpandBits16(static_cast<uint32_t>(bits >> cell)));
+      }
+#endif
+      for (; cell < cells; cell += 8) {
+        const uint64_t bytes = ExpandBits8((bits >> cell) & 0xff);
+        std::memcpy(pixels + column + cell, &bytes, std::min(8, cells - cell));
+      }
+    }
+  }
+}
+
+void StatesToGrayscale(const Board& alive, const std::vector<Board>& ages, int stateCount, int x, int y, int width,
+                       int height, uint8_t* out) {
+  if (ages.empty()) {
+    BoardToGrayscale(alive, x, y, width, height, out);
+    return;
+  }
+  // A dying cell of age a shows (steps - a) * ramp / 256: just under 255 at age 1, falling by ramp / 256 per
+  // generation. Ages stay below 256, so they fit in a byte and (steps - a) * 256 in 16 bits.
+  const int planes = std::min(static_cast<int>(ages.size()), 8);
+  const int steps = std::clamp(stateCount - 1, 1, 255);
+  const int ramp = 255 * 256 / steps;
+#if LIFE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i stepsWide = _mm_set1_epi16(static_cast<int16_t>(steps));
+  const __m128i rampWide = _mm_set1_epi16(static_cast<int16_t>(ramp));
+#endif
+  uint64_t ageBits[8];
+  for (int row = 0; row < height; ++row) {
+    const uint64_t* words = alive.Row(y + row);
+    uint8_t* pixels = out + static_cast<size_t>(row) * width;
+    for (int column = 0; column < width; column += Board::kBitsPerWord) {
+      const uint64_t aliveBits = CellsAt(words, alive.WordsPerRow(), x + column);
+      for (int k = 0; k < planes; ++k) ageBits[k] = CellsAt(ages[k].Row(y + row), alive.WordsPerRow(), x + column);
+      const int cells = std::min(Board::kBitsPerWord, width - column);
+      int cell = 0;
+#if LIFE_SSE2
+      for (; cell + 16 <= cells; cell += 16) {
+        // Gather the 16 ages as bytes from the planes, then scale them 8 at a time in 16-bit lanes
+        __m128i age = zero;
+        for (int k = 0; k < planes; ++k) {
+          const __m128i plane = ExpandBits16(static_cast<uint32_t>(ageBits[k] >> cell));
+          age = _mm_or_si128(age, _mm_and_si128(plane, _mm_set1_epi8(static_cast<char>(1 << k))));
+        }
+        const __m128i low = _mm_mulhi_epu16(_mm_slli_epi16(_mm_sub_epi16(stepsWide, _mm_unpacklo_epi8(age, zero)), 8),
+                                            rampWide);
+        const __m128i high = _mm_mulhi_epu16(_mm_slli_epi16(_mm_sub_epi16(stepsWide, _mm_unpackhi_epi8(age, zero)), 8),
+                                             rampWide);
+        // Cells of age 0 are live or dead rather than dying; live ones are all ones
+        const __m128i dying = _mm_andnot_si128(_mm_cmpeq_epi8(age, zero), _mm_packus_epi16(low, high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + column + cell),
+                         _mm_or_si128(dying, ExpandBits16(static_cast<uint32_t>(aliveBits >> cell))));
+      }
+#endif
+      for (; cell < cells; ++cell) {
+        int age = 0;
+        for (int k = 0; k < planes; ++k) age |= static_cast<int>((ageBits[k] >> cell) & 1) << k;
+        const bool isAlive = (aliveBits >> cell) & 1;
+        pixels[column + cell] = isAlive ? 255 : age == 0 ? 0 : static_cast<uint8_t>(((steps - age) * ramp) >> 8);
+      }
+    }
+  }
+}
+
+void BoardToRgba(const Board& board, int x, int y, int width, int height, Rgba alive, Rgba dead, uint8_t* out) {
+#if LIFE_SSE2
+  const __m128i aliveColor = _mm_set1_epi32(static_cast<int>(std::bit_cast<uint32_t>(alive)));
+  const __m128i deadColor = _mm_set1_epi32(static_cast<int>(std::bit_cast<uint32_t>(dead)));
+#endif
+  for (int row = 0; row < height; ++row) {
+    const uint64_t* words = board.Row(y + row);
+    uint8_t* pixels = out + static_cast<size_t>(row) * width * 4;
+    for (int column = 0; column < width; column += Board::kBitsPerWord) {
+      const uint64_t bits = CellsAt(words, board.WordsPerRow(), x + column);
+      const int cells = std::min(Board::kBitsPerWord, width - column);
+      int cell = 0;
+#if LIFE_SSE2
+      for (; cell + 16 <= cells; cell += 16) {
+        // Widen the 16 byte masks to one 32-bit mask per pixel and pick between the two colors with it
+        const __m128i mask = ExpandBits16(static_cast<uint32_t>(bits >> cell));
+        const __m128i low = _mm_unpacklo_epi8(mask, mask);
+        const __m128i high = _mm_unpackhi_epi8(mask, mask);
+        const __m128i pixelMasks[4] = {_mm_unpacklo_epi16(low, low), _mm_unpackhi_epi16(low, low),
+                                       _mm_unpacklo_epi16(high, high), _mm_unpackhi_epi16(high, high)};
+        __m128i* target = reinterpret_cast<__m128i*>(pixels + static_cast<size_t>(column + cell) * 4);
+        for (int i = 0; i < 4; ++i) {
+          _mm_storeu_si128(target + i, _mm_or_si128(_mm_and_si128(pixelMasks[i], aliveColor),
+                                                    _mm_andnot_si128(pixelMasks[i], deadColor)));
+        }
+      }
+#endif
+      for (; cell < cells; ++cell) {
+        std::memcpy(pixels + static_cast<size_t>(column + cell) * 4, (bits >> cell) & 1 ? &alive : &dead, 4);
+      }
+    }
+  }
+}
+
+Board PlaceBoard(const Board& pattern, int width, int height, int x, int y) {
+  Board board(width, height);
+  // Every source word lands across at most two target words; floor division keeps negative offsets right
+  const int64_t firstWord = (x >= 0 ? x : x - (Board::kBitsPerWord - 1)) / Board::kBitsPerWord;
+  const int shift = static_cast<int>(x - firstWord * Board::kBitsPerWord);
+  // Only source words that land on the board, so cropping a small window out of a huge board stays cheap
+  const int firstSource = static_cast<int>(std::clamp<int64_t>(-firstWord - 1, 0, pattern.WordsPerRow()));
+  const int endSource =
+      static_cast<int>(std::clamp<int64_t>(board.WordsPerRow() - firstWord, 0, pattern.WordsPerRow()));
+  for (int row = std::max(0, -y); row < pattern.Height() && y + row < height; ++row) {
+    const uint64_t* in = pattern.Row(row);
+    uint64_t* out = board.Row(y + row);
+    for (int i = firstSource; i < endSource; ++i) {
+      if (in[i] == 0) continue;
+      const int64_t target = firstWord + i;
+      if (target >= 0 && target < board.WordsPerRow()) out[target] |= in[i] << shift;
+      if (shift != 0 && target + 1 >= 0 && target + 1 < board.WordsPerRow()) {
+        out[target + 1] |= in[i] >> (Board::kBitsPerWord - shift);
+      }
+    }
+    if (board.WordsPerRow() > 0) out[board.WordsPerRow() - 1] &= board.TailMask();
+  }
+  return board;
+}
+
+Board RandomBoard(int width, int height, double density, uint64_t seed) {
+  Board board(width, height);
+  const int threshold = static_cast<int>(std::clamp(density, 0.0, 1.0) * 256.0 + 0.5);
+  if (threshold == 0) return board;
+  // xorshift64*; each word combines eight random words along the binary expansion of threshold / 256, which sets
+  // every bit with exactly that probability
+  uint64_t state = seed * 0x9e3779b97f4a7c15ull + 1;
+  auto next = [&state] {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dull;
+  };
+  uint64_t* words = board.Data();
+  for (size_t i = 0; i < board.WordCount(); ++i) {
+    uint64_t word = ~uint64_t{0};
+    if (threshold < 256) {
+      word = 0;
+      for (int bit = 0; bit < 8; ++bit) word = ((threshold >> bit) & 1) ? (word | next()) : (word & next());
+    }
+    const bool lastInRow = (i + 1) % board.WordsPerRow() == 0;
+    words[i] = lastInRow ? word & board.TailMask() : word;
+  }
+  return board;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Game of Life world stored as one bit per cell. Each row is padded up to a whole number of 64-bit words so the step
+// kernels can work on 64 cells at a time. Bit (x % 64) of word (x / 64) holds cell x; padding bits past the board
+// width are always kept at zero.
+class Board {
+ public:
+  static constexpr int kBitsPerWord = 64;
+
+  Board() = default;
+  Board(int width, int height);
+
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+  int WordsPerRow() const { return wordsPerRow_; }
+
+  // Mask of the valid cell bits in the last word of each row
+  uint64_t TailMask() const { return tailMask_; }
+
+  bool Get(int x, int y) const {
+    return (words_[static_cast<size_t>(y) * wordsPerRow_ + x / kBitsPerWord] >> (x % kBitsPerWord)) & 1;
+  }
+
+  void Set(int x, int y, bool alive) {
+    uint64_t& word = words_[static_cast<size_t>(y) * wordsPerRow_ + x / kBitsPerWord];
+    const uint64_t bit = uint64_t{1} << (x % kBitsPerWord);
+    word = alive ? (word | bit) : (word & ~bit);
+  }
+
+  uint64_t* Row(int y) { return words_.data() + static_cast<size_t>(y) * wordsPerRow_; }
+  const uint64_t* Row(int y) const { return words_.data() + static_cast<size_t>(y) * wordsPerRow_; }
+
+  uint64_t* Data() { return words_.data(); }
+  const uint64_t* Data() const { return words_.data(); }
+  size_t WordCount() const { return words_.size(); }
+
+  void Clear();
+  size_t Population() const;
+
+  bool operator==(const Board& other) const = default;
+
+ private:
+  int width_ = 0;
+  int height_ = 0;
+  int wordsPerRow_ = 0;
+  uint64_t tailMask_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+// Luma at or above which a pixel of an opaque image is a live cell
+constexpr uint8_t kLumaThreshold = 128;
+
+// Builds a board from interleaved 8-bit pixels of `bytesPerPixel` bytes each, rows packed without gaps. A cell is
+// alive when byte `channel` of its pixel is at least `threshold`. One, two and four byte pixels are thresholded 64 at a
+// time with SSE2 where available.
+Board BoardFromChannel(const uint8_t* pixels, int width, int height, int bytesPerPixel, int channel, uint8_t threshold);
+
+// Builds a board from 8-bit RGBA pixels. A cell is alive when its pixel is not fully transparent.
+Board BoardFromRgba(const uint8_t* pixels, int width, int height);
+
+// Builds a board from 8-bit RGB pixels. A cell is alive when its luma (0.299 R + 0.587 G + 0.114 B) is at least
+// `threshold`. Rows go 64 pixels at a time with SSE2 where available.
+Board BoardFromRgbLuma(const uint8_t* pixels, int width, int height, uint8_t threshold);
+
+// Expands the width x height block of cells starting at (x, y) into tightly packed 8-bit grayscale pixels: 255 for live
+// cells, 0 for dead ones. Works 16 cells at a time with SSE2 where available, 8 otherwise. Rows are independent, so
+// large blocks can be split by rows across threads.
+void BoardToGrayscale(const Board& board, int x, int y, int width, int height, uint8_t* out);
+
+// Same as BoardToGrayscale for the cells of a Generations rule with `stateCount` states, whose dying cells' ages are
+// spread over the bit planes `ages` (see Engine::ViewAges): 255 for live cells, 0 for dead ones, and for dying cells a
+// level that falls evenly from just under 255 towards 0 as they age. Empty `ages` means a two-state board.
+void StatesToGrayscale(const Board& alive, const std::vector<Board>& ages, int stateCount, int x, int y, int width,
+                       int height, uint8_t* out);
+
+// An 8-bit RGBA pixel in memory order
+struct Rgba {
+  uint8_t r, g, b, a;
+};
+
+// Same as BoardToGrayscale for 4-byte RGBA pixels, `alive` for live cells and `dead` for dead ones
+void BoardToRgba(const Board& board, int x, int y, int width, int height, Rgba alive, Rgba dead, uint8_t* out);
+
+// Copies `pattern` into a blank width x height board with its top-left cell at (x, y). Cells falling outside the new
+// board are dropped; x and y may be negative, so this also crops a window out of a larger board.
+Board PlaceBoard(const Board& pattern, int width, int height, int x, int y);
+
+// Random soup where each cell is alive with probability `density` (to 1/256 precision). Deterministic for a given
+// seed, and fast enough to fill benchmark boards with billions of cells.
+Board RandomBoard(int width, int height, double density, uint64_t seed);
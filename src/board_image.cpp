@@ -0,0 +1,38 @@
+#include "board_image.h"
+
+namespace {
+
+bool HasAlpha(int format) {
+  return format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA || format == PIXELFORMAT_UNCOMPRESSED_R5G5B5A1 ||
+         format == PIXELFORMAT_UNCOMPRESSED_R4G4B4A4 || format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 ||
+         format == PIXELFORMAT_UNCOMPRESSED_R32G32B32A32;
+}
+
+}  // namespace
+
+Board BoardFromImage(const Image& image) {
+  const uint8_t* pixels = static_cast<const uint8_t*>(image.data);
+  switch (image.format) {
+    case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+      return BoardFromChannel(pixels, image.width, image.height, 1, 0, kLumaThreshold);
+    case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+      return BoardFromChannel(pixels, image.width, image.height, 2, 1, 1);
+    case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+      return BoardFromRgbLuma(pixels, image.width, image.height, kLumaThreshold);
+    case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
+      return BoardFromRgba(pixels, image.width, image.height);
+    default:
+      break;
+  }
+  if (image.format >= PIXELFORMAT_COMPRESSED_DXT1_RGB) {
+    TraceLog(LOG_WARNING, "LIFE: compressed images are not supported, starting from an empty board");
+    return Board(image.width, image.height);
+  }
+  // Packed and float formats are rare for patterns; raylib converts them to the nearest 8-bit one first
+  Image converted = ImageCopy(image);
+  ImageFormat(&converted,
+              HasAlpha(image.format) ? PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA : PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+  Board board = BoardFromImage(converted);
+  UnloadImage(converted);
+  return board;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "board.h"
+#include "raylib.h"
+
+// Conversion from raylib Images to the packed simulation Board. Images only exist for loading patterns; the display
+// reads the board directly (see BoardRenderer).
+
+// Builds a board from an image in any uncompressed format, reading its pixels in place. In formats with alpha a cell
+// is alive when its pixel is not fully transparent; in opaque ones (grayscale, RGB) when it is bright (see
+// kLumaThreshold). Paletted PNGs load as RGB or RGBA.
+Board BoardFromImage(const Image& image);
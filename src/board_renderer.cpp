@@ -0,0 +1,226 @@
+#include "board_renderer.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+
+// Grayscale textures sample as (l, l, l, 1) on every raylib backend, so the red channel is the cell level: 1 for live
+// cells, 0 for dead ones and in between for dying ones
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+const char* const kPaletteShader = R"(#version 100
+precision mediump float;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 aliveColor;
+uniform vec4 deadColor;
+void main() {
+  float level = texture2D(texture0, fragTexCoord).r;
+  gl_FragColor = mix(deadColor, aliveColor, level) * fragColor;
+}
+)";
+#else
+const char* const kPaletteShader = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 aliveColor;
+uniform vec4 deadColor;
+out vec4 finalColor;
+void main() {
+  float level = texture(texture0, fragTexCoord).r;
+  finalColor = mix(deadColor, aliveColor, level) * fragColor;
+}
+)";
+#endif
+
+void SetColorUniform(Shader shader, int location, Color color) {
+  const float value[4] = {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f};
+  SetShaderValue(shader, location, value, SHADER_UNIFORM_VEC4);
+}
+
+}  // namespace
+
+BoardRenderer::BoardRenderer(int screenWidth, int screenHeight, Color alive, Color dead, int stateCount,
+                             int expandThreads)
+    : stateCount_(stateCount),
+      // A cell or block cut by each window edge adds one texel per axis
+      textureWidth_(screenWidth + 2),
+      textureHeight_(screenHeight + 2),
+      pool_(expandThreads > 1 ? std::make_unique<ThreadPool>(expandThreads) : nullptr),
+      pixels_(static_cast<size_t>(textureWidth_) * textureHeight_, 0) {
+  Image blank{pixels_.data(), textureWidth_, textureHeight_, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE};
+  texture_ = LoadTextureFromImage(blank);
+  shader_ = LoadShaderFromMemory(nullptr, kPaletteShader);
+  aliveLocation_ = GetShaderLocation(shader_, "aliveColor");
+  deadLocation_ = GetShaderLocation(shader_, "deadColor");
+  SetPalette(alive, dead);
+}
+
+BoardRenderer::~BoardRenderer() {
+  UnloadShader(shader_);
+  UnloadTexture(texture_);
+}
+
+void BoardRenderer::SetPalette(Color alive, Color dead) {
+  SetColorUniform(shader_, aliveLocation_, alive);
+  SetColorUniform(shader_, deadLocation_, dead);
+}
+
+void BoardRenderer::Update(const Board& alive, const std::vector<Board>& ages, const DensityPyramid& density,
+                           const Viewport& viewport, bool boardChanged) {
+  lastUpload_ = UploadStats{};
+
+  Region region;
+  region.level = viewport.DetailLevel();
+  const int64_t scale = int64_t{1} << region.level;
+  const int64_t texelsX = (alive.Width() + scale - 1) / scale;
+  const int64_t texelsY = (alive.Height() + scale - 1) / scale;
+  const Vector2 origin = viewport.Origin();
+  const float zoom = viewport.Zoom();
+  const double left = std::floor(origin.x / static_cast<double>(scale));
+  const double top = std::floor(origin.y / static_cast<double>(scale));
+  const double right = std::ceil((origin.x + viewport.ScreenWidth() / zoom) / static_cast<double>(scale));
+  const double bottom = std::ceil((origin.y + viewport.ScreenHeight() / zoom) / static_cast<double>(scale));
+  region.x = static_cast<int>(std::clamp<double>(left, 0, static_cast<double>(texelsX)));
+  region.y = static_cast<int>(std::clamp<double>(top, 0, static_cast<double>(texelsY)));
+  region.width = static_cast<int>(std::clamp<double>(right, region.x, static_cast<double>(texelsX))) - region.x;
+  region.height = static_cast<int>(std::clamp<double>(bottom, region.y, static_cast<double>(texelsY))) - region.y;
+  region.width = std::min(region.width, textureWidth_);
+  region.height = std::min(region.height, textureHeight_);
+
+  // Sub-texel pans only move the quad
+  const float texelSize = static_cast<float>(scale) * zoom;
+  dest_ = {(static_cast<float>(region.x * scale) - origin.x) * zoom,
+           (static_cast<float>(region.y * scale) - origin.y) * zoom, region.width * texelSize,
+           region.height * texelSize};
+  const bool regionChanged = region != region_;
+  region_ = region;
+  if ((!boardChanged && !regionChanged) || region.width == 0 || region.height == 0) return;
+
+  if (region.level == 0) {
+    UpdateCells(alive, ages, regionChanged);
+  } else {
+    UpdateDensity(alive, density);
+  }
+}
+
+void BoardRenderer::UpdateCells(const Board& alive, const std::vector<Board>& ages, bool regionChanged) {
+  const int width = region_.width;
+  const int height = region_.height;
+  visible_ = PlaceBoard(alive, width, height, -region_.x, -region_.y);
+  visibleAges_.resize(ages.size());
+  for (size_t k = 0; k < ages.size(); ++k) visibleAges_[k] = PlaceBoard(ages[k], width, height, -region_.x, -region_.y);
+
+  if (regionChanged || shown_.size() != ages.size() + 1) {
+    // Nothing on the GPU lines up with the new region
+    Upload(visible_, visibleAges_, 0, 0, width, height);
+    lastUpload_.fullUpload = true;
+  } else {
+    const int blocksX = visible_.WordsPerRow();
+    const int blocksY = (height + kBlockSize - 1) / kBlockSize;
+    dirty_.assign(static_cast<size_t>(blocksX) * blocksY, 0);
+    uint64_t dirtyCells = 0;
+    for (int blockY = 0; blockY < blocksY; ++blockY) {
+      const int yBegin = blockY * kBlockSize;
+      const int yEnd = std::min(yBegin + kBlockSize, height);
+      for (int blockX = 0; blockX < blocksX; ++blockX) {
+        uint64_t difference = 0;
+        for (int y = yBegin; y < yEnd && difference == 0; ++y) {
+          difference = visible_.Row(y)[blockX] ^ shown_[0].Row(y)[blockX];
+          for (size_t k = 0; k < ages.size(); ++k) {
+            difference |= visibleAges_[k].Row(y)[blockX] ^ shown_[k + 1].Row(y)[blockX];
+          }
+        }
+        if (difference == 0) continue;
+        dirty_[blockY * blocksX + blockX] = 1;
+        dirtyCells += static_cast<uint64_t>(std::min(kBlockSize, width - blockX * kBlockSize)) * (yEnd - yBegin);
+      }
+    }
+    if (dirtyCells == 0) return;
+
+    if (dirtyCells > fullUploadThreshold_ * static_cast<float>(width) * static_cast<float>(height)) {
+      Upload(visible_, visibleAges_, 0, 0, width, height);
+      lastUpload_.fullUpload = true;
+    } else {
+      // One rectangle per horizontal run of dirty blocks
+      for (int blockY = 0; blockY < blocksY; ++blockY) {
+        const int y = blockY * kBlockSize;
+        const int rows = std::min(kBlockSize, height - y);
+        for (int blockX = 0; blockX < blocksX;) {
+          if (!dirty_[blockY * blocksX + blockX]) {
+            ++blockX;
+            continue;
+          }
+          const int runBegin = blockX;
+          while (blockX < blocksX && dirty_[blockY * blocksX + blockX]) ++blockX;
+          const int x = runBegin * kBlockSize;
+          Upload(visible_, visibleAges_, x, y, std::min(blockX * kBlockSize, width) - x, rows);
+        }
+      }
+    }
+  }
+  shown_.resize(ages.size() + 1);
+  shown_[0] = visible_;
+  std::copy(visibleAges_.begin(), visibleAges_.end(), shown_.begin() + 1);
+}
+
+void BoardRenderer::UpdateDensity(const Board& alive, const DensityPyramid& density) {
+  const int level = region_.level;
+  const int scale = 1 << std::min(level, 30);
+  const uint64_t blockCells = uint64_t{1} << (2 * level);
+  // Levels past the top of the pyramid have a single texel, which the top block covers
+  const int pyramidLevel = std::min(level, density.TopLevel());
+  for (int row = 0; row < region_.height; ++row) {
+    const int texelY = region_.y + row;
+    uint8_t* out = pixels_.data() + static_cast<size_t>(row) * region_.width;
+    for (int column = 0; column < region_.width; ++column) {
+      const int texelX = region_.x + column;
+      uint64_t count = 0;
+      if (level >= DensityPyramid::kBaseLevel) {
+        count = density.Count(pyramidLevel, texelX, texelY);
+      } else {
+        // 2x2 and 4x4 blocks never straddle a word, so each block row is one shift and mask
+        const int x = texelX * scale;
+        const uint64_t mask = (uint64_t{1} << scale) - 1;
+        for (int y = texelY * scale; y < std::min((texelY + 1) * scale, alive.Height()); ++y) {
+          count += std::popcount((alive.Row(y)[x / Board::kBitsPerWord] >> (x % Board::kBitsPerWord)) & mask);
+        }
+      }
+      // Any live cell shows up, however sparse its block
+      out[column] = count == 0 ? 0 : static_cast<uint8_t>(64 + 191 * count / blockCells);
+    }
+  }
+  const Rectangle rect{0, 0, static_cast<float>(region_.width), static_cast<float>(region_.height)};
+  UpdateTextureRec(texture_, rect, pixels_.data());
+  lastUpload_ = {1, static_cast<uint64_t>(region_.width) * region_.height, true};
+  // The cell planes on the GPU are gone
+  shown_.clear();
+}
+
+void BoardRenderer::Draw() const {
+  if (region_.width == 0 || region_.height == 0) return;
+  const Rectangle source{0, 0, static_cast<float>(region_.width), static_cast<float>(region_.height)};
+  BeginShaderMode(shader_);
+  DrawTexturePro(texture_, source, dest_, Vector2{0, 0}, 0.0f, WHITE);
+  EndShaderMode();
+}
+
+void BoardRenderer::Upload(const Board& alive, const std::vector<Board>& ages, int x, int y, int width, int height) {
+  if (pool_ && static_cast<int64_t>(width) * height >= kParallelExpandPixels) {
+    // One band of rows per thread, each writing its own part of the buffer
+    pool_->RunRanges(height, [&](int begin, int end) {
+      StatesToGrayscale(alive, ages, stateCount_, x, y + begin, width, end - begin,
+                        pixels_.data() + static_cast<size_t>(begin) * width);
+    });
+  } else {
+    StatesToGrayscale(alive, ages, stateCount_, x, y, width, height, pixels_.data());
+  }
+  const Rectangle rect{static_cast<float>(x), static_cast<float>(y), static_cast<float>(width),
+                       static_cast<float>(height)};
+  UpdateTextureRec(texture_, rect, pixels_.data());
+  ++lastUpload_.rectangles;
+  lastUpload_.pixels += static_cast<uint64_t>(width) * height;
+}
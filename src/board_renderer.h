@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board.h"
+#include "density_pyramid.h"
+#include "raylib.h"
+#include "thread_pool.h"
+#include "viewport.h"
+
+struct UploadStats {
+  int rectangles = 0;
+  uint64_t pixels = 0;
+  bool fullUpload = false;
+};
+
+// Owns the board texture and keeps it in sync with the simulation. The texture only ever holds what the viewport
+// shows, so it is the size of the window and upload cost follows screen pixels rather than board cells.
+//
+// Zoomed in (at most one cell per screen pixel), each texel is one cell. Each Update() compares the visible cells
+// against the state already on the GPU in 64x64-cell blocks, merges neighboring changed blocks in a block row into
+// rectangles and uploads only those with UpdateTextureRec. When the changed area is large, one full upload is cheaper
+// than many small ones, so it falls back to that.
+//
+// Zoomed out, each texel covers a 2^level x 2^level block of cells (see Viewport::DetailLevel) and shows its density.
+// Blocks of 8x8 cells and up come from the board's DensityPyramid, so a texel costs one lookup however many cells it
+// covers.
+//
+// The texture is single-channel (one byte per cell, 255 = alive) and a small fragment shader maps it to the palette
+// while drawing, so uploads are a quarter of the RGBA size and the palette can change without touching any buffers.
+// Dying cells of Generations rules get intermediate levels, which the shader turns into a ramp from the live color
+// towards the dead one. Cells are expanded to texels with the vector kernels of BoardToGrayscale into one reused
+// buffer, and large uploads are split by rows across the renderer's own worker threads.
+class BoardRenderer {
+ public:
+  // Blocks are one board word wide so change detection is a word compare
+  static constexpr int kBlockSize = Board::kBitsPerWord;
+  // Uploads smaller than this are expanded on the calling thread alone
+  static constexpr int kParallelExpandPixels = 1 << 18;
+
+  // Must be created after the window (texture creation needs the OpenGL context). `stateCount` is the rule's number
+  // of cell states (see Engine::StateCount), and `expandThreads` how many threads expand large uploads.
+  BoardRenderer(int screenWidth, int screenHeight, Color alive, Color dead, int stateCount = 2, int expandThreads = 1);
+  ~BoardRenderer();
+
+  BoardRenderer(const BoardRenderer&) = delete;
+  BoardRenderer& operator=(const BoardRenderer&) = delete;
+
+  // `ages` are the decay planes of Generations rules (see Engine::ViewAges), empty otherwise, and `density` the block
+  // populations of `alive`. `boardChanged` says whether the board differs from the last call; when neither it nor the
+  // visible region changed, nothing is uploaded.
+  void Update(const Board& alive, const std::vector<Board>& ages, const DensityPyramid& density,
+              const Viewport& viewport, bool boardChanged);
+  // Draws the region of the last Update() where the viewport puts it, with the current palette
+  void Draw() const;
+
+  void SetPalette(Color alive, Color dead);
+
+  const Texture2D& Texture() const { return texture_; }
+  const UploadStats& LastUpload() const { return lastUpload_; }
+
+  // Fraction of the visible region above which a full upload replaces the sub-rectangle uploads
+  void SetFullUploadThreshold(float fraction) { fullUploadThreshold_ = fraction; }
+
+ private:
+  // Visible part of the board in texels of the current level
+  struct Region {
+    int level = -1;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool operator==(const Region& other) const = default;
+  };
+
+  void UpdateCells(const Board& alive, const std::vector<Board>& ages, bool regionChanged);
+  void UpdateDensity(const Board& alive, const DensityPyramid& density);
+  void Upload(const Board& alive, const std::vector<Board>& ages, int x, int y, int width, int height);
+
+  int stateCount_;
+  int textureWidth_;
+  int textureHeight_;
+  Region region_;
+  Rectangle dest_{0, 0, 0, 0};
+  // Visible alive plane followed by the visible age planes, as currently on the GPU
+  std::vector<Board> shown_;
+  // The same planes cropped from the latest board
+  Board visible_;
+  std::vector<Board> visibleAges_;
+  Texture2D texture_;
+  Shader shader_;
+  int aliveLocation_ = -1;
+  int deadLocation_ = -1;
+  float fullUploadThreshold_ = 0.5f;
+  std::unique_ptr<ThreadPool> pool_;
+  std::vector<uint8_t> pixels_;
+  std::vector<uint8_t> dirty_;
+  UploadStats lastUpload_;
+};
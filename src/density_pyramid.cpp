@@ -0,0 +1,130 @@
+#include "density_pyramid.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Per-byte popcounts of a word, each byte holding 0..8
+inline uint64_t BytePopcounts(uint64_t word) {
+  word = word - ((word >> 1) & 0x5555555555555555ull);
+  word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+  return (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+}
+
+}  // namespace
+
+void DensityPyramid::Build(const Board& board) {
+  constexpr int kBlock = 1 << kBaseLevel;
+  width_ = board.Width();
+  height_ = board.Height();
+  levels_.assign(1, Level{});
+  Level& base = levels_[0];
+  base.blocksX = (width_ + kBlock - 1) / kBlock;
+  base.blocksY = (height_ + kBlock - 1) / kBlock;
+  base.counts.assign(static_cast<size_t>(base.blocksX) * base.blocksY, 0);
+  for (int blockY = 0; blockY < base.blocksY; ++blockY) CountBaseRow(board, blockY, 0, base.blocksX);
+  BuildUpperLevels();
+}
+
+void DensityPyramid::Update(const Board& board, const std::vector<CellRect>& changed) {
+  if (levels_.empty() || board.Width() != width_ || board.Height() != height_) {
+    Build(board);
+    return;
+  }
+  constexpr int kBlock = 1 << kBaseLevel;
+  for (const CellRect& rect : changed) {
+    const int xBegin = std::clamp(rect.x, 0, width_);
+    const int yBegin = std::clamp(rect.y, 0, height_);
+    const int xEnd = std::clamp(rect.x + rect.width, xBegin, width_);
+    const int yEnd = std::clamp(rect.y + rect.height, yBegin, height_);
+    if (xBegin == xEnd || yBegin == yEnd) continue;
+    // Block range touched at the current level, halved (rounding outwards) on the way up
+    int blockXBegin = xBegin / kBlock;
+    int blockYBegin = yBegin / kBlock;
+    int blockXEnd = (xEnd + kBlock - 1) / kBlock;
+    int blockYEnd = (yEnd + kBlock - 1) / kBlock;
+    for (int blockY = blockYBegin; blockY < blockYEnd; ++blockY) CountBaseRow(board, blockY, blockXBegin, blockXEnd);
+    for (size_t index = 1; index < levels_.size(); ++index) {
+      const Level& below = levels_[index - 1];
+      Level& level = levels_[index];
+      blockXBegin /= 2;
+      blockYBegin /= 2;
+      blockXEnd = (blockXEnd + 1) / 2;
+      blockYEnd = (blockYEnd + 1) / 2;
+      for (int blockY = blockYBegin; blockY < blockYEnd; ++blockY) {
+        const uint64_t* top = &below.counts[static_cast<size_t>(2 * blockY) * below.blocksX];
+        const uint64_t* bottom = 2 * blockY + 1 < below.blocksY ? top + below.blocksX : nullptr;
+        uint64_t* out = &level.counts[static_cast<size_t>(blockY) * level.blocksX];
+        for (int blockX = blockXBegin; blockX < blockXEnd; ++blockX) {
+          const int left = 2 * blockX;
+          const bool hasRight = left + 1 < below.blocksX;
+          uint64_t sum = top[left] + (hasRight ? top[left + 1] : 0);
+          if (bottom != nullptr) sum += bottom[left] + (hasRight ? bottom[left + 1] : 0);
+          out[blockX] = sum;
+        }
+      }
+    }
+  }
+}
+
+uint64_t DensityPyramid::Population() const {
+  return levels_.empty() || levels_.back().counts.empty() ? 0 : levels_.back().counts[0];
+}
+
+uint64_t DensityPyramid::CountBlocks(int level, int blockX, int blockY, int blocksWide, int blocksHigh) const {
+  const Level& entry = levels_[level - kBaseLevel];
+  const int xBegin = std::clamp(blockX, 0, entry.blocksX);
+  const int yBegin = std::clamp(blockY, 0, entry.blocksY);
+  const int xEnd = static_cast<int>(std::clamp<int64_t>(int64_t{blockX} + blocksWide, xBegin, entry.blocksX));
+  const int yEnd = static_cast<int>(std::clamp<int64_t>(int64_t{blockY} + blocksHigh, yBegin, entry.blocksY));
+  uint64_t sum = 0;
+  for (int y = yBegin; y < yEnd; ++y) {
+    const uint64_t* row = &entry.counts[static_cast<size_t>(y) * entry.blocksX];
+    for (int x = xBegin; x < xEnd; ++x) sum += row[x];
+  }
+  return sum;
+}
+
+int DensityPyramid::OccupiedBlocks(int level) const {
+  if (levels_.empty()) return 0;
+  const Level& entry = levels_[std::clamp(level, kBaseLevel, TopLevel()) - kBaseLevel];
+  return static_cast<int>(
+      std::count_if(entry.counts.begin(), entry.counts.end(), [](uint64_t count) { return count != 0; }));
+}
+
+void DensityPyramid::CountBaseRow(const Board& board, int blockY, int blockBegin, int blockEnd) {
+  constexpr int kBlock = 1 << kBaseLevel;
+  constexpr int kBlocksPerWord = Board::kBitsPerWord / kBlock;
+  Level& base = levels_[0];
+  const int yBegin = blockY * kBlock;
+  const int yEnd = std::min(yBegin + kBlock, board.Height());
+  uint64_t* counts = &base.counts[static_cast<size_t>(blockY) * base.blocksX];
+  // A byte of a word is one 8-cell row of a block, so summing eight rows' byte popcounts gives eight block counts
+  // (at most 64 each, still one byte) per word
+  for (int word = blockBegin / kBlocksPerWord; word * kBlocksPerWord < blockEnd; ++word) {
+    uint64_t sums = 0;
+    for (int y = yBegin; y < yEnd; ++y) sums += BytePopcounts(board.Row(y)[word]);
+    const int wordBlock = word * kBlocksPerWord;
+    for (int block = std::max(wordBlock, blockBegin); block < std::min(wordBlock + kBlocksPerWord, blockEnd); ++block) {
+      counts[block] = (sums >> ((block - wordBlock) * 8)) & 0xff;
+    }
+  }
+}
+
+void DensityPyramid::BuildUpperLevels() {
+  levels_.resize(1);
+  while (levels_.back().blocksX > 1 || levels_.back().blocksY > 1) {
+    const Level& below = levels_.back();
+    Level level;
+    level.blocksX = (below.blocksX + 1) / 2;
+    level.blocksY = (below.blocksY + 1) / 2;
+    level.counts.assign(static_cast<size_t>(level.blocksX) * level.blocksY, 0);
+    for (int y = 0; y < below.blocksY; ++y) {
+      const uint64_t* in = &below.counts[static_cast<size_t>(y) * below.blocksX];
+      uint64_t* out = &level.counts[static_cast<size_t>(y / 2) * level.blocksX];
+      for (int x = 0; x < below.blocksX; ++x) out[x / 2] += in[x];
+    }
+    levels_.push_back(std::move(level));
+  }
+}
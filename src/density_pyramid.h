@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+#include "engine.h"
+
+// Live-cell counts of square blocks at every scale from 8x8 cells up to a single block covering the board, each level
+// summing 2x2 blocks of the one below. Zoomed-out views read one count per screen pixel from the matching level instead
+// of visiting every cell it covers, and the coarser levels answer population questions about large areas in a few
+// lookups.
+//
+// Update() keeps the pyramid in sync from the regions an engine reports as changed (see Engine::TakeChangedRegions):
+// only the 8x8 blocks under those regions are recounted, and above them only their ancestors are re-summed, so a
+// generation costs in proportion to its activity rather than to the board's area.
+class DensityPyramid {
+ public:
+  // Level k holds blocks of 2^k x 2^k cells; the finest stored level is 8x8
+  static constexpr int kBaseLevel = 3;
+
+  DensityPyramid() = default;
+  explicit DensityPyramid(const Board& board) { Build(board); }
+
+  void Build(const Board& board);
+  // Recounts the blocks under `changed`, which must cover every cell that differs from the board last counted.
+  // Rebuilds from scratch if the board's size changed.
+  void Update(const Board& board, const std::vector<CellRect>& changed);
+
+  // Levels kBaseLevel .. TopLevel() exist once built
+  int TopLevel() const { return kBaseLevel + static_cast<int>(levels_.size()) - 1; }
+  int BlocksX(int level) const { return levels_[level - kBaseLevel].blocksX; }
+  int BlocksY(int level) const { return levels_[level - kBaseLevel].blocksY; }
+  // Live cells in block (blockX, blockY) of `level`, which must be in range
+  uint64_t Count(int level, int blockX, int blockY) const {
+    const Level& entry = levels_[level - kBaseLevel];
+    return entry.counts[static_cast<size_t>(blockY) * entry.blocksX + blockX];
+  }
+
+  uint64_t Population() const;
+  // Live cells in a range of blocks of `level`, clipped to the board
+  uint64_t CountBlocks(int level, int blockX, int blockY, int blocksWide, int blocksHigh) const;
+  // Blocks of `level` holding at least one live cell, a measure of how far the pattern is spread out. Levels above
+  // TopLevel() count as the single top block.
+  int OccupiedBlocks(int level) const;
+
+ private:
+  struct Level {
+    int blocksX = 0;
+    int blocksY = 0;
+    std::vector<uint64_t> counts;
+  };
+
+  // Recounts base blocks [blockBegin, blockEnd) of one block row from the board
+  void CountBaseRow(const Board& board, int blockY, int blockBegin, int blockEnd);
+  void BuildUpperLevels();
+
+  int width_ = 0;
+  int height_ = 0;
+  std::vector<Level> levels_;
+};
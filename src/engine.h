@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "board.h"
+
+// Axis-aligned rectangle of cells
+struct CellRect {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+};
+
+// Interface shared by the simulation engines so main() can pick one at startup and display any of them through the
+// same board texture path.
+class Engine {
+ public:
+  virtual ~Engine() = default;
+
+  virtual const char* Name() const = 0;
+
+  virtual void Advance(uint64_t generations) = 0;
+  virtual uint64_t Generation() const = 0;
+  virtual uint64_t Population() const = 0;
+
+  // Current state of the board-sized region shown on screen. The reference stays valid until the next Advance().
+  virtual const Board& View() = 0;
+
+  // Cell states of the rule being run: 2 for Life-like rules, more for Generations rules (see Rule)
+  virtual int StateCount() const { return 2; }
+  // Decay ages of the region View() shows, as bit planes: bit k of a dying cell's age (1 for state 2, 2 for state 3,
+  // ...) is in plane k, and live and dead cells have age 0. Empty for two-state rules. Same lifetime as View().
+  virtual const std::vector<Board>& ViewAges() {
+    static const std::vector<Board> kNoAges;
+    return kNoAges;
+  }
+
+  // Appends rectangles covering every cell of View() that may have changed since the previous call (or since the
+  // engine was created) and returns true. Engines that do not track changes return false: anything may have changed.
+  virtual bool TakeChangedRegions(std::vector<CellRect>* /*regions*/) { return false; }
+
+  // Every live cell on a board of its own, for saving: View() on a bounded board, and on an unbounded plane the
+  // bounding box of all live cells, wherever they have wandered. Returns false with *error set when that box holds more
+  // than kMaxExportCells cells or is more than INT_MAX cells on a side.
+  static constexpr int64_t kMaxExportCells = int64_t{1} << 32;
+  virtual bool ExportBoard(Board* board, std::string* /*error*/) {
+    *board = View();
+    return true;
+  }
+};
@@ -0,0 +1,205 @@
+#include "engine_config.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <utility>
+
+#include "generations_engine.h"
+#include "sparse_engine.h"
+
+const char* const kEngineUsage =
+    "  --engine=packed|hashlife|sparse  simulation engine: a torus the size of the pattern (packed) or an\n"
+    "                                   unbounded plane (hashlife, sparse)\n"
+    "  --rule=<rule>                    B/S rule such as B36/S23, Generations rule such as B2/S/C3, or one of\n"
+    "                                   life, highlife, seeds, daynight, briansbrain, starwars; Larger than\n"
+    "                                   Life rule such as R5,C0,M1,S34..58,B34..45,NM or bosco (packed only)\n"
+    "  --board=<w>x<h>                  board size (default: the pattern's size)\n"
+    "  --at=center|<x>,<y>              where the pattern's top-left cell goes on the board (default: center)\n"
+    "  --kernel=<name>                  force a step kernel (scalar, sse2, avx2, avx512)\n"
+    "  --threads=<n>                    worker threads (default: hardware threads)\n"
+    "  --schedule=tiles|stripes         how each generation is split across threads\n"
+    "  --tile-size=<cells>              edge of the work-stealing tiles\n"
+    "  --all-tiles                      step every tile, not just those near recent changes\n"
+    "  --hashlife-memory=<MiB>          HashLife node cache size that triggers garbage collection\n";
+
+namespace {
+
+bool ParseFlag(std::string_view arg, std::string_view name, std::string_view* value) {
+  if (!arg.starts_with(name) || arg.size() <= name.size() || arg[name.size()] != '=') return false;
+  *value = arg.substr(name.size() + 1);
+  return true;
+}
+
+// Rules outside plain Life-like B/S ones only run on the packed engine
+bool CheckEngineSupportsRule(const EngineConfig& config, std::string* error) {
+  if (config.engine == "packed") return true;
+  if (config.largerThanLife) {
+    *error = "Larger than Life rules are only supported by --engine=packed";
+    return false;
+  }
+  if ((config.rule.birth & 1) != 0) {
+    *error = "rules with B0 need a bounded board; use --engine=packed";
+    return false;
+  }
+  if (config.rule.states > 2) {
+    *error = "Generations rules are only supported by --engine=packed";
+    return false;
+  }
+  return true;
+}
+
+// "<a><separator><b>" with two non-negative numbers no larger than `limit`
+bool ParsePair(std::string_view text, char separator, int limit, int* a, int* b) {
+  const size_t split = text.find(separator);
+  uint64_t first = 0;
+  uint64_t second = 0;
+  if (split == std::string_view::npos || !ParseNumber(text.substr(0, split), &first) ||
+      !ParseNumber(text.substr(split + 1), &second) || first > static_cast<uint64_t>(limit) ||
+      second > static_cast<uint64_t>(limit)) {
+    return false;
+  }
+  *a = static_cast<int>(first);
+  *b = static_cast<int>(second);
+  return true;
+}
+
+}  // namespace
+
+bool ParseNumber(std::string_view text, uint64_t* value) {
+  const char* end = text.data() + text.size();
+  const auto [parsedEnd, errorCode] = std::from_chars(text.data(), end, *value);
+  return !text.empty() && errorCode == std::errc{} && parsedEnd == end;
+}
+
+bool ParseDimensions(std::string_view text, int* width, int* height) {
+  return ParsePair(text, 'x', 1 << 20, width, height) && *width > 0 && *height > 0;
+}
+
+bool ParseEngineArgument(std::string_view arg, EngineConfig* config, std::string* error) {
+  std::string_view value;
+  uint64_t number = 0;
+  if (ParseFlag(arg, "--engine", &value)) {
+    if (value != "packed" && value != "hashlife" && value != "sparse") {
+      *error = "unknown engine '" + std::string(value) + "'";
+    }
+    config->engine = value;
+  } else if (ParseFlag(arg, "--rule", &value)) {
+    SetConfigRule(value, config, error);
+  } else if (ParseFlag(arg, "--board", &value)) {
+    if (!ParseDimensions(value, &config->layout.width, &config->layout.height)) {
+      *error = "invalid board size, expected e.g. 1920x1080";
+    }
+  } else if (ParseFlag(arg, "--at", &value)) {
+    config->layout.centered = value == "center";
+    if (!config->layout.centered && !ParsePair(value, ',', 1 << 20, &config->layout.x, &config->layout.y)) {
+      *error = "invalid pattern position, expected center or <x>,<y>";
+    }
+  } else if (ParseFlag(arg, "--kernel", &value)) {
+    config->kernel = value;
+  } else if (ParseFlag(arg, "--threads", &value)) {
+    if (!ParseNumber(value, &number) || number == 0 || number > 4096) *error = "invalid thread count";
+    config->packed.threads = static_cast<int>(std::min<uint64_t>(number, 4096));
+  } else if (ParseFlag(arg, "--schedule", &value)) {
+    if (value == "tiles") {
+      config->packed.schedule = Schedule::kTiles;
+    } else if (value == "stripes") {
+      config->packed.schedule = Schedule::kStripes;
+    } else {
+      *error = "unknown schedule '" + std::string(value) + "'";
+    }
+  } else if (ParseFlag(arg, "--tile-size", &value)) {
+    if (!ParseNumber(value, &number) || number == 0 || number > (1 << 20)) *error = "invalid tile size";
+    config->packed.tileSize = static_cast<int>(std::min<uint64_t>(number, 1 << 20));
+  } else if (arg == "--all-tiles") {
+    config->packed.skipStableTiles = false;
+  } else if (ParseFlag(arg, "--hashlife-memory", &value)) {
+    if (!ParseNumber(value, &number) || number == 0 || number > (SIZE_MAX >> 20)) {
+      *error = "invalid HashLife memory budget";
+    }
+    config->hashLife.memoryBudgetBytes = static_cast<size_t>(std::min<uint64_t>(number, SIZE_MAX >> 20)) << 20;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool SetConfigRule(std::string_view text, EngineConfig* config, std::string* error) {
+  if (text == "bosco" || (text.size() > 1 && (text[0] == 'R' || text[0] == 'r') && text[1] >= '0' && text[1] <= '9')) {
+    LargerThanLifeRule rule;
+    if (!ParseLargerThanLifeRule(text, &rule, error)) return false;
+    config->largerThanLife = rule;
+    return true;
+  }
+  if (!ParseRule(text, &config->rule, error)) return false;
+  config->largerThanLife.reset();
+  return true;
+}
+
+const StepKernel* ResolveKernel(const EngineConfig& config, std::string* error) {
+  const StepKernel* kernel = SelectKernel(config.kernel);
+  if (kernel == nullptr) *error = "step kernel '" + config.kernel + "' is not available on this CPU";
+  return kernel;
+}
+
+std::string ConfigRuleString(const EngineConfig& config) {
+  return config.largerThanLife ? LargerThanLifeRuleString(*config.largerThanLife) : RuleString(config.rule);
+}
+
+Board LayOutBoard(const BoardLayout& layout, Board pattern) {
+  if (layout.width == 0 && (layout.centered || (layout.x == 0 && layout.y == 0))) return pattern;
+  const int width = layout.width > 0 ? layout.width : pattern.Width();
+  const int height = layout.height > 0 ? layout.height : pattern.Height();
+  const int x = layout.centered ? (width - pattern.Width()) / 2 : layout.x;
+  const int y = layout.centered ? (height - pattern.Height()) / 2 : layout.y;
+  return PlaceBoard(pattern, width, height, x, y);
+}
+
+std::unique_ptr<Engine> CreateEngine(const EngineConfig& config, Board initial, std::string* error) {
+  return CreateEngine(config, std::move(initial), {}, error);
+}
+
+std::unique_ptr<Engine> CreateEngine(const EngineConfig& config, Board initial, std::vector<Board> ages,
+                                     std::string* error) {
+  const StepKernel* kernel = ResolveKernel(config, error);
+  if (kernel == nullptr || !CheckEngineSupportsRule(config, error)) return nullptr;
+  initial = LayOutBoard(config.layout, std::move(initial));
+  if (config.largerThanLife) {
+    return std::make_unique<LargerThanLifeEngine>(initial,
+                                                  LargerThanLifeOptions{*config.largerThanLife, config.packed.threads});
+  }
+  const RowKernel rowKernel = kernel->ForRule(config.rule);
+  if (config.engine == "hashlife") {
+    HashLifeOptions options = config.hashLife;
+    options.rule = config.rule;
+    return std::make_unique<HashLifeEngine>(initial, options);
+  }
+  if (config.engine == "sparse") {
+    return std::make_unique<SparseEngine>(initial, SparseEngineOptions{rowKernel, config.rule});
+  }
+  if (config.engine == "packed" && config.rule.states > 2) {
+    for (Board& plane : ages) plane = LayOutBoard(config.layout, std::move(plane));
+    return std::make_unique<GenerationsEngine>(std::move(initial), ages,
+                                               GenerationsEngineOptions{rowKernel, config.rule, config.packed.threads});
+  }
+  if (config.engine == "packed") {
+    PackedEngineOptions options = config.packed;
+    options.kernel = rowKernel;
+    options.rule = config.rule;
+    return std::make_unique<PackedEngine>(std::move(initial), options);
+  }
+  *error = "unknown engine '" + config.engine + "'";
+  return nullptr;
+}
+
+std::unique_ptr<Engine> CreateEngine(const EngineConfig& config, const Quadtree& tree, std::string* error) {
+  if (config.engine == "hashlife" && config.layout.width == 0) {
+    if (!CheckEngineSupportsRule(config, error)) return nullptr;
+    HashLifeOptions options = config.hashLife;
+    options.rule = config.rule;
+    return std::make_unique<HashLifeEngine>(tree, options);
+  }
+  // Everything else starts from the board the tree decodes to
+  HashLifeEngine decoder(tree, HashLifeOptions{});
+  return CreateEngine(config, decoder.View(), error);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "board.h"
+#include "engine.h"
+#include "hashlife.h"
+#include "larger_than_life.h"
+#include "packed_engine.h"
+#include "rule.h"
+#include "step.h"
+
+// Where the starting pattern goes on the board
+struct BoardLayout {
+  // 0 keeps the pattern's own size
+  int width = 0;
+  int height = 0;
+  // Otherwise the pattern's top-left cell goes to (x, y)
+  bool centered = true;
+  int x = 0;
+  int y = 0;
+};
+
+// Engine settings shared by every executable, filled in from command-line flags
+struct EngineConfig {
+  std::string engine = "packed";
+  // Empty picks the fastest kernel the CPU supports
+  std::string kernel;
+  Rule rule = kConwayRule;
+  // Set when --rule named a Larger than Life rule, which then replaces `rule`
+  std::optional<LargerThanLifeRule> largerThanLife;
+  BoardLayout layout;
+  PackedEngineOptions packed{.threads = ThreadPool::DefaultThreadCount()};
+  HashLifeOptions hashLife;
+};
+
+// Usage lines for the flags understood by ParseEngineArgument
+extern const char* const kEngineUsage;
+
+// Applies one engine flag. Returns false when `arg` is not an engine flag; returns true with *error set when it is
+// one but its value is invalid.
+bool ParseEngineArgument(std::string_view arg, EngineConfig* config, std::string* error);
+
+// Sets the rule from its --rule text (any form ParseRule or ParseLargerThanLifeRule accepts)
+bool SetConfigRule(std::string_view text, EngineConfig* config, std::string* error);
+
+// Resolves the configured step kernel, or returns nullptr with *error set
+const StepKernel* ResolveKernel(const EngineConfig& config, std::string* error);
+
+// The configured rule in its canonical notation
+std::string ConfigRuleString(const EngineConfig& config);
+
+// Places `pattern` on a board as `layout` describes
+Board LayOutBoard(const BoardLayout& layout, Board pattern);
+
+// Builds the configured engine starting from `initial` laid out per config.layout, or returns nullptr with *error set
+std::unique_ptr<Engine> CreateEngine(const EngineConfig& config, Board initial, std::string* error);
+// Same with the decay ages of a multi-state pattern (see Engine::ViewAges), laid out like `initial`. Only Generations
+// rules keep them; every other engine starts those cells dead.
+std::unique_ptr<Engine> CreateEngine(const EngineConfig& config, Board initial, std::vector<Board> ages,
+                                     std::string* error);
+// Same from a quadtree (see Quadtree), which the hashlife engine adopts without ever decoding it to a board unless a
+// board size is configured. The others start from the region HashLifeEngine would show.
+std::unique_ptr<Engine> CreateEngine(const EngineConfig& config, const Quadtree& tree, std::string* error);
+
+// Parses a whole non-negative decimal number, rejecting trailing characters
+bool ParseNumber(std::string_view text, uint64_t* value);
+// Parses "<width>x<height>" with both sides in 1..2^20
+bool ParseDimensions(std::string_view text, int* width, int* height);
@@ -0,0 +1,48 @@
+#include "generation_clock.h"
+
+#include <algorithm>
+
+namespace {
+
+// Weight of the newest sample in the running per-generation cost
+constexpr double kCostSmoothing = 0.25;
+constexpr double kRateWindowSeconds = 0.5;
+// Keeps owed_ well inside the range where it converts to uint64_t exactly
+constexpr double kMaxOwed = 0x1p62;
+
+}  // namespace
+
+GenerationClock::GenerationClock(double generationsPerSecond, uint64_t quantum)
+    : rate_(std::max(generationsPerSecond, 0.0)), quantum_(std::max<uint64_t>(quantum, 1)) {}
+
+void GenerationClock::SetRate(double generationsPerSecond) {
+  rate_ = std::max(generationsPerSecond, 0.0);
+  owed_ = 0;
+}
+
+uint64_t GenerationClock::Plan(double elapsedSeconds, double budgetSeconds) {
+  windowSeconds_ += elapsedSeconds;
+  if (windowSeconds_ >= kRateWindowSeconds) {
+    measuredRate_ = static_cast<double>(windowGenerations_) / windowSeconds_;
+    windowSeconds_ = 0;
+    windowGenerations_ = 0;
+  }
+
+  owed_ = rate_ > 0 ? std::min(owed_ + elapsedSeconds * rate_, kMaxOwed) : kMaxOwed;
+  // Until the first batch has been timed only a single quantum is trusted to fit
+  const double affordable = secondsPerGeneration_ > 0 ? budgetSeconds / secondsPerGeneration_ : 0;
+  // Drop whatever does not fit the budget, but always make progress once a full quantum is owed
+  owed_ = std::min(owed_, std::max(affordable, static_cast<double>(quantum_)));
+  const uint64_t generations = static_cast<uint64_t>(owed_) / quantum_ * quantum_;
+  owed_ -= static_cast<double>(generations);
+  if (rate_ == 0) owed_ = 0;
+  return generations;
+}
+
+void GenerationClock::Record(uint64_t generations, double seconds) {
+  if (generations == 0) return;
+  windowGenerations_ += generations;
+  const double cost = seconds / static_cast<double>(generations);
+  secondsPerGeneration_ =
+      secondsPerGeneration_ > 0 ? secondsPerGeneration_ + kCostSmoothing * (cost - secondsPerGeneration_) : cost;
+}
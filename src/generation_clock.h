@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Fixed-timestep scheduler that decouples the simulation rate from the frame rate. Real time accrues generations at the
+// requested rate; each frame the caller asks how many of the owed generations to run, steps them, and reports how long
+// that took. The per-generation cost learned from those reports caps every batch to a time budget, so a rate the
+// machine cannot sustain slows the simulation down instead of stalling rendering, and the generations that did not fit
+// are dropped rather than piling up.
+class GenerationClock {
+ public:
+  // A rate of 0 runs as many generations as the budget allows. Batches are always whole multiples of `quantum`.
+  explicit GenerationClock(double generationsPerSecond, uint64_t quantum = 1);
+
+  double Rate() const { return rate_; }
+  void SetRate(double generationsPerSecond);
+  uint64_t Quantum() const { return quantum_; }
+
+  // Generations to step for a frame that took `elapsedSeconds`, limited so stepping them is expected to take no longer
+  // than `budgetSeconds`
+  uint64_t Plan(double elapsedSeconds, double budgetSeconds);
+
+  // Reports that stepping `generations` took `seconds`
+  void Record(uint64_t generations, double seconds);
+
+  // Generations actually stepped per second of real time, averaged over roughly the last half second
+  double MeasuredRate() const { return measuredRate_; }
+
+ private:
+  double rate_;
+  uint64_t quantum_;
+  double owed_ = 0;
+  double secondsPerGeneration_ = 0;
+
+  double windowSeconds_ = 0;
+  uint64_t windowGenerations_ = 0;
+  double measuredRate_ = 0;
+};
@@ -0,0 +1,94 @@
+#include "generations_engine.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+GenerationsEngine::GenerationsEngine(Board initial, const GenerationsEngineOptions& options)
+    : options_(options), alive_(std::move(initial)), nextAlive_(alive_.Width(), alive_.Height()) {
+  options_.rule.states = std::clamp<uint16_t>(options_.rule.states, 2, kMaxStates);
+  // Ages run up to states - 1, the value that wraps back to 0 (dead)
+  const int planes = std::bit_width(static_cast<unsigned>(options_.rule.states - 1));
+  ages_.assign(options_.rule.states > 2 ? planes : 0, Board(alive_.Width(), alive_.Height()));
+  const int threads = std::clamp(options_.threads, 1, std::max(alive_.Height(), 1));
+  if (threads > 1) pool_ = std::make_unique<ThreadPool>(threads);
+}
+
+GenerationsEngine::GenerationsEngine(Board initial, const std::vector<Board>& ages,
+                                     const GenerationsEngineOptions& options)
+    : GenerationsEngine(std::move(initial), options) {
+  const int planes = static_cast<int>(ages_.size());
+  const unsigned wrapAge = options_.rule.states - 1;
+  for (const Board& plane : ages) {
+    if (plane.Width() != alive_.Width() || plane.Height() != alive_.Height()) return;
+  }
+  for (size_t i = 0; i < alive_.WordCount(); ++i) {
+    // Bit-sliced age >= wrapAge, from the top bit down; bits above the engine's planes are too old already
+    uint64_t tooOld = 0;
+    for (size_t k = static_cast<size_t>(planes); k < ages.size(); ++k) tooOld |= ages[k].Data()[i];
+    uint64_t equal = ~uint64_t{0};
+    for (int k = planes - 1; k >= 0; --k) {
+      const uint64_t age = k < static_cast<int>(ages.size()) ? ages[k].Data()[i] : 0;
+      if ((wrapAge >> k) & 1) {
+        equal &= age;
+      } else {
+        tooOld |= equal & age;
+        equal &= ~age;
+      }
+    }
+    const uint64_t keep = ~(tooOld | equal | alive_.Data()[i]);
+    for (int k = 0; k < planes && k < static_cast<int>(ages.size()); ++k) ages_[k].Data()[i] = ages[k].Data()[i] & keep;
+  }
+}
+
+void GenerationsEngine::Advance(uint64_t generations) {
+  for (uint64_t i = 0; i < generations; ++i) Step();
+}
+
+void GenerationsEngine::Step() {
+  if (pool_) {
+    const int stripeCount = pool_->ThreadCount();
+    pool_->Run([this, stripeCount](int worker) { StepStripe(worker, stripeCount); });
+  } else {
+    StepStripe(0, 1);
+  }
+  std::swap(alive_, nextAlive_);
+  ++generation_;
+}
+
+void GenerationsEngine::StepStripe(int stripe, int stripeCount) {
+  // The B/S step only reads alive_ and writes this stripe's rows of nextAlive_; the decay pass below touches nothing
+  // but this stripe's words, so one barrier per generation is enough
+  const int height = alive_.Height();
+  const int yBegin = static_cast<int>(static_cast<int64_t>(height) * stripe / stripeCount);
+  const int yEnd = static_cast<int>(static_cast<int64_t>(height) * (stripe + 1) / stripeCount);
+  StepRows(options_.kernel, options_.rule, alive_, &nextAlive_, yBegin, yEnd, 0, alive_.WordsPerRow());
+
+  const int planes = static_cast<int>(ages_.size());
+  const unsigned wrapAge = options_.rule.states - 1;
+  const size_t begin = static_cast<size_t>(yBegin) * alive_.WordsPerRow();
+  const size_t end = static_cast<size_t>(yEnd) * alive_.WordsPerRow();
+  const uint64_t* alive = alive_.Data();
+  uint64_t* next = nextAlive_.Data();
+  for (size_t i = begin; i < end; ++i) {
+    uint64_t dying = 0;
+    for (int k = 0; k < planes; ++k) dying |= ages_[k].Data()[i];
+    // Dying cells are not dead yet, so the B/S step's births on them do not count
+    const uint64_t nextAlive = next[i] & ~dying;
+    const uint64_t startDying = alive[i] & ~nextAlive;
+
+    // age += 1 for dying cells, then back to 0 for those that reached states - 1
+    uint64_t carry = dying;
+    uint64_t wrapped = dying;
+    for (int k = 0; k < planes; ++k) {
+      uint64_t& age = ages_[k].Data()[i];
+      const uint64_t sum = age ^ carry;
+      carry &= age;
+      age = sum;
+      wrapped &= ((wrapAge >> k) & 1) ? sum : ~sum;
+    }
+    for (int k = 0; k < planes; ++k) ages_[k].Data()[i] &= ~wrapped;
+    if (planes > 0) ages_[0].Data()[i] |= startDying;
+    next[i] = nextAlive;
+  }
+}
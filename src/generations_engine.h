@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board.h"
+#include "engine.h"
+#include "rule.h"
+#include "step.h"
+#include "thread_pool.h"
+
+struct GenerationsEngineOptions {
+  // Must be a kernel made for `rule` (see StepKernel::ForRule); the default handles any rule
+  RowKernel kernel = StepRowScalar;
+  Rule rule = kBriansBrainRule;
+  // Worker threads stepping the board; 1 steps everything on the calling thread
+  int threads = 1;
+};
+
+// Generations rules (see Rule) on a torus, stored as bit planes: the packed alive plane, stepped by the regular B/S
+// row kernels, plus the binary decay age of every cell spread over a few more planes. Everything else is word-parallel
+// logic on 64 cells at a time: births are masked by the dying cells, cells that fail to survive start at age 1, and
+// the ages of dying cells go through a bit-sliced increment that wraps to 0 once a cell has passed its last state.
+class GenerationsEngine : public Engine {
+ public:
+  GenerationsEngine(Board initial, const GenerationsEngineOptions& options);
+  // Also starts with dying cells, given as age planes sized like `initial` (see ViewAges). Ages past the rule's last
+  // state, and ages of live cells, are dropped.
+  GenerationsEngine(Board initial, const std::vector<Board>& ages, const GenerationsEngineOptions& options);
+
+  const char* Name() const override { return "generations"; }
+  void Advance(uint64_t generations) override;
+  uint64_t Generation() const override { return generation_; }
+  // Live cells only; dying cells do not count
+  uint64_t Population() const override { return alive_.Population(); }
+  const Board& View() override { return alive_; }
+  int StateCount() const override { return options_.rule.states; }
+  const std::vector<Board>& ViewAges() override { return ages_; }
+
+  void Step();
+
+ private:
+  void StepStripe(int stripe, int stripeCount);
+
+  GenerationsEngineOptions options_;
+  Board alive_;
+  Board nextAlive_;
+  std::vector<Board> ages_;
+  std::unique_ptr<ThreadPool> pool_;
+  uint64_t generation_ = 0;
+};
@@ -0,0 +1,452 @@
+#include "hashlife.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <string>
+
+#include "step_logic.h"
+
+struct HashLifeEngine::Node {
+  // Children, null for leaves
+  Node* nw = nullptr;
+  Node* ne = nullptr;
+  Node* sw = nullptr;
+  Node* se = nullptr;
+  // Memoized RESULT for `resultStep`
+  Node* result = nullptr;
+  // Next node in the same hash bucket, or in the free list
+  Node* next = nullptr;
+  // Leaves only: row r of the 8x8 block in byte r, column c in bit c of that byte
+  uint64_t bits = 0;
+  uint64_t population = 0;
+  int8_t level = 0;
+  int8_t resultStep = -1;
+  bool marked = false;
+};
+
+namespace {
+
+constexpr size_t kNodesPerBlock = 1 << 16;
+
+inline size_t HashChildren(const void* nw, const void* ne, const void* sw, const void* se) {
+  size_t hash = reinterpret_cast<uintptr_t>(nw);
+  hash = hash * 0x9e3779b97f4a7c15ull + reinterpret_cast<uintptr_t>(ne);
+  hash = hash * 0x9e3779b97f4a7c15ull + reinterpret_cast<uintptr_t>(sw);
+  hash = hash * 0x9e3779b97f4a7c15ull + reinterpret_cast<uintptr_t>(se);
+  return hash ^ (hash >> 29);
+}
+
+inline size_t HashLeaf(uint64_t bits) {
+  const uint64_t hash = (bits ^ (bits >> 31)) * 0xbf58476d1ce4e5b9ull;
+  return hash ^ (hash >> 27);
+}
+
+inline uint32_t LeafRow(uint64_t bits, int row) { return static_cast<uint32_t>(bits >> (row * 8)) & 0xff; }
+
+}  // namespace
+
+HashLifeEngine::HashLifeEngine(const Board& initial, const HashLifeOptions& options)
+    : options_(options),
+      buckets_(size_t{1} << 16, nullptr),
+      collectionThreshold_(options.memoryBudgetBytes),
+      view_(initial.Width(), initial.Height()) {
+  int level = kLeafLevel + 1;
+  while ((int64_t{1} << level) < std::max(initial.Width(), initial.Height())) ++level;
+  root_ = Build(initial, level, 0, 0);
+}
+
+HashLifeEngine::HashLifeEngine(const Quadtree& tree, const HashLifeOptions& options)
+    : options_(options), buckets_(size_t{1} << 16, nullptr), collectionThreshold_(options.memoryBudgetBytes) {
+  // Children precede their parents, so one forward pass builds every node. An empty child takes its size from the
+  // parent.
+  std::vector<Node*> nodes(tree.size(), nullptr);
+  for (size_t i = 1; i < tree.size(); ++i) {
+    const QuadtreeNode& node = tree[i];
+    if (node.level == kLeafLevel) {
+      nodes[i] = Leaf(node.bits);
+      continue;
+    }
+    auto child = [&](uint32_t index) { return index == 0 ? Empty(node.level - 1) : nodes[index]; };
+    nodes[i] = Join(child(node.nw), child(node.ne), child(node.sw), child(node.se));
+  }
+  root_ = tree.size() > 1 ? nodes.back() : Empty(kLeafLevel + 1);
+  if (root_->level == kLeafLevel) root_ = Join(root_, Empty(kLeafLevel), Empty(kLeafLevel), Empty(kLeafLevel));
+
+  // An empty universe gets a 1x1 view
+  std::unordered_map<const Node*, Extent> extents;
+  const Extent bounds = root_->population == 0 ? Extent{0, 0, 0, 0} : Bounds(root_, &extents);
+  rootX_ = -bounds.minX;
+  rootY_ = -bounds.minY;
+  view_ = Board(static_cast<int>(std::min<int64_t>(bounds.maxX - bounds.minX + 1, kMaxTreeView)),
+                static_cast<int>(std::min<int64_t>(bounds.maxY - bounds.minY + 1, kMaxTreeView)));
+}
+
+HashLifeEngine::~HashLifeEngine() = default;
+
+uint64_t HashLifeEngine::Population() const { return root_->population; }
+
+size_t HashLifeEngine::MemoryUsage() const {
+  return nodeCount_ * sizeof(Node) + buckets_.size() * sizeof(Node*);
+}
+
+void HashLifeEngine::Advance(uint64_t generations) {
+  for (int exponent = 0; generations != 0; ++exponent, generations >>= 1) {
+    if (generations & 1) AdvancePowerOfTwo(exponent);
+  }
+}
+
+void HashLifeEngine::AdvancePowerOfTwo(int exponent) {
+  // RESULT only covers the centre half of the root, and the pattern can spread one cell per generation. Keeping all
+  // live cells inside the centre quarter with 2^exponent <= 2^(level-3) guarantees nothing is lost.
+  const int minimumLevel = std::max(exponent + 3, kLeafLevel + 2);
+  while (root_->level < minimumLevel || Centered(Centered(root_))->population != root_->population) Expand();
+  const int64_t offset = int64_t{1} << (root_->level - 2);
+  root_ = Result(root_, exponent);
+  rootX_ += offset;
+  rootY_ += offset;
+  generation_ += uint64_t{1} << exponent;
+}
+
+const Board& HashLifeEngine::View() {
+  if (viewGeneration_ != generation_) {
+    view_.Clear();
+    Render(root_, rootX_, rootY_, &view_);
+    viewGeneration_ = generation_;
+  }
+  return view_;
+}
+
+bool HashLifeEngine::ExportBoard(Board* board, std::string* error) {
+  if (root_->population == 0) {
+    *board = Board(1, 1);
+    return true;
+  }
+  std::unordered_map<const Node*, Extent> extents;
+  const Extent bounds = Bounds(root_, &extents);
+  const int64_t width = bounds.maxX - bounds.minX + 1;
+  const int64_t height = bounds.maxY - bounds.minY + 1;
+  // Board sizes are ints, so a long thin box fails too; checking each side first also keeps the product in range
+  if (width > INT_MAX || height > INT_MAX || width * height > kMaxExportCells) {
+    *error = "live cells span " + std::to_string(width) + "x" + std::to_string(height) + ", too large for a board";
+    return false;
+  }
+  *board = Board(static_cast<int>(width), static_cast<int>(height));
+  Render(root_, -bounds.minX, -bounds.minY, board);
+  return true;
+}
+
+HashLifeEngine::Node* HashLifeEngine::Allocate() {
+  if (freeList_ == nullptr) {
+    blocks_.push_back(std::make_unique<Node[]>(kNodesPerBlock));
+    Node* block = blocks_.back().get();
+    for (size_t i = 0; i < kNodesPerBlock; ++i) {
+      block[i].next = freeList_;
+      freeList_ = &block[i];
+    }
+  }
+  Node* node = freeList_;
+  freeList_ = node->next;
+  *node = Node{};
+  ++nodeCount_;
+  return node;
+}
+
+HashLifeEngine::Node* HashLifeEngine::Leaf(uint64_t bits) {
+  const size_t bucket = HashLeaf(bits) & (buckets_.size() - 1);
+  for (Node* node = buckets_[bucket]; node != nullptr; node = node->next) {
+    if (node->level == kLeafLevel && node->bits == bits) return node;
+  }
+  Node* node = Allocate();
+  node->bits = bits;
+  node->population = std::popcount(bits);
+  node->level = kLeafLevel;
+  Insert(node);
+  return node;
+}
+
+HashLifeEngine::Node* HashLifeEngine::Join(Node* nw, Node* ne, Node* sw, Node* se) {
+  const size_t bucket = HashChildren(nw, ne, sw, se) & (buckets_.size() - 1);
+  for (Node* node = buckets_[bucket]; node != nullptr; node = node->next) {
+    if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) return node;
+  }
+  Node* node = Allocate();
+  node->nw = nw;
+  node->ne = ne;
+  node->sw = sw;
+  node->se = se;
+  node->population = nw->population + ne->population + sw->population + se->population;
+  node->level = static_cast<int8_t>(nw->level + 1);
+  Insert(node);
+  return node;
+}
+
+HashLifeEngine::Node* HashLifeEngine::Empty(int level) {
+  while (static_cast<int>(empty_.size()) <= level) {
+    const int emptyLevel = static_cast<int>(empty_.size());
+    if (emptyLevel < kLeafLevel) {
+      empty_.push_back(nullptr);
+    } else if (emptyLevel == kLeafLevel) {
+      empty_.push_back(Leaf(0));
+    } else {
+      Node* child = empty_.back();
+      empty_.push_back(Join(child, child, child, child));
+    }
+  }
+  return empty_[level];
+}
+
+HashLifeEngine::Node* HashLifeEngine::Centered(Node* node) {
+  if (node->level == kLeafLevel + 1) return LeafResult(node, 0);
+  return Join(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+HashLifeEngine::Node* HashLifeEngine::Result(Node* node, int step) {
+  if (node->result != nullptr && node->resultStep == step) return node->result;
+  // Everything this evaluation holds across a recursive call stays pinned until it returns, so the collections those
+  // calls may run cannot free it
+  const size_t pinnedBegin = pinned_.size();
+  pinned_.push_back(node);
+  MaybeCollectGarbage();
+  Node* result;
+  if (node->population == 0) {
+    result = Empty(node->level - 1);
+  } else if (node->level == kLeafLevel + 1) {
+    result = LeafResult(node, 1 << step);
+  } else {
+    // The nine overlapping level-(k-1) sub-squares...
+    Node* n[9] = {node->nw,
+                  Join(node->nw->ne, node->ne->nw, node->nw->se, node->ne->sw),
+                  node->ne,
+                  Join(node->nw->sw, node->nw->se, node->sw->nw, node->sw->ne),
+                  Join(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw),
+                  Join(node->ne->sw, node->ne->se, node->se->nw, node->se->ne),
+                  node->sw,
+                  Join(node->sw->ne, node->se->nw, node->sw->se, node->se->sw),
+                  node->se};
+    pinned_.insert(pinned_.end(), n, n + 9);
+
+    // ...reduced to their centres, advanced half the way when taking the full 2^(k-2) step...
+    const bool fullStep = step == node->level - 2;
+    Node* r[9];
+    for (int i = 0; i < 9; ++i) {
+      r[i] = fullStep ? Result(n[i], step - 1) : Centered(n[i]);
+      pinned_.push_back(r[i]);
+    }
+
+    // ...then regrouped into four level-(k-1) squares whose results tile the centre of this node
+    const int secondStep = fullStep ? step - 1 : step;
+    Node* quadrants[4];
+    for (int i = 0; i < 4; ++i) {
+      const int corner = (i / 2) * 3 + i % 2;
+      quadrants[i] = Result(Join(r[corner], r[corner + 1], r[corner + 3], r[corner + 4]), secondStep);
+      pinned_.push_back(quadrants[i]);
+    }
+    result = Join(quadrants[0], quadrants[1], quadrants[2], quadrants[3]);
+  }
+  node->result = result;
+  node->resultStep = static_cast<int8_t>(step);
+  pinned_.resize(pinnedBegin);
+  return result;
+}
+
+HashLifeEngine::Node* HashLifeEngine::LeafResult(Node* node, int generations) {
+  // Brute force on the 16x16 block, one uint32_t per row. Each generation the valid region shrinks by a cell on every
+  // side, which still leaves the centre 8x8 exact after the at most 4 generations a level-4 node can advance.
+  uint32_t rows[16];
+  for (int r = 0; r < 8; ++r) {
+    rows[r] = LeafRow(node->nw->bits, r) | (LeafRow(node->ne->bits, r) << 8);
+    rows[r + 8] = LeafRow(node->sw->bits, r) | (LeafRow(node->se->bits, r) << 8);
+  }
+  const bool conway = ClassifyRule(options_.rule) == RuleFamily::kConway;
+  for (int generation = 0; generation < generations; ++generation) {
+    uint32_t next[16] = {};
+    for (int r = 1; r < 15; ++r) {
+      const uint32_t above = rows[r - 1];
+      const uint32_t row = rows[r];
+      const uint32_t below = rows[r + 1];
+      const NeighborCount<uint32_t> count =
+          CountNeighbors(above << 1, above, above >> 1, row << 1, row >> 1, below << 1, below, below >> 1);
+      next[r] = conway ? ConwayRule::Next(count, row, options_.rule) : GenericRule::Next(count, row, options_.rule);
+    }
+    std::copy(next, next + 16, rows);
+  }
+  uint64_t bits = 0;
+  for (int r = 0; r < 8; ++r) bits |= static_cast<uint64_t>((rows[r + 4] >> 4) & 0xff) << (r * 8);
+  return Leaf(bits);
+}
+
+HashLifeEngine::Node* HashLifeEngine::Build(const Board& board, int level, int64_t x, int64_t y) {
+  if (x >= board.Width() || y >= board.Height()) return Empty(level);
+  if (level == kLeafLevel) {
+    uint64_t bits = 0;
+    for (int r = 0; r < 8 && y + r < board.Height(); ++r) {
+      // Leaves start on multiples of 8, so a leaf row never straddles two board words
+      const uint64_t word = board.Row(static_cast<int>(y + r))[x / Board::kBitsPerWord];
+      bits |= ((word >> (x % Board::kBitsPerWord)) & 0xff) << (r * 8);
+    }
+    return Leaf(bits);
+  }
+  const int64_t half = int64_t{1} << (level - 1);
+  return Join(Build(board, level - 1, x, y), Build(board, level - 1, x + half, y),
+              Build(board, level - 1, x, y + half), Build(board, level - 1, x + half, y + half));
+}
+
+void HashLifeEngine::Render(const Node* node, int64_t x, int64_t y, Board* out) const {
+  const int64_t size = int64_t{1} << node->level;
+  if (node->population == 0 || x >= out->Width() || y >= out->Height() || x + size <= 0 || y + size <= 0) return;
+  if (node->level == kLeafLevel) {
+    for (uint64_t bits = node->bits; bits != 0; bits &= bits - 1) {
+      const int bit = std::countr_zero(bits);
+      const int64_t cellX = x + bit % 8;
+      const int64_t cellY = y + bit / 8;
+      if (cellX >= 0 && cellY >= 0 && cellX < out->Width() && cellY < out->Height()) {
+        out->Set(static_cast<int>(cellX), static_cast<int>(cellY), true);
+      }
+    }
+    return;
+  }
+  const int64_t half = size / 2;
+  Render(node->nw, x, y, out);
+  Render(node->ne, x + half, y, out);
+  Render(node->sw, x, y + half, out);
+  Render(node->se, x + half, y + half, out);
+}
+
+HashLifeEngine::Extent HashLifeEngine::Bounds(const Node* node, std::unordered_map<const Node*, Extent>* extents) {
+  // Memoized per node, so the cost follows the number of distinct nodes rather than the area they cover
+  const auto found = extents->find(node);
+  if (found != extents->end()) return found->second;
+  Extent extent{INT64_MAX, INT64_MAX, INT64_MIN, INT64_MIN};
+  if (node->level == kLeafLevel) {
+    for (uint64_t bits = node->bits; bits != 0; bits &= bits - 1) {
+      const int bit = std::countr_zero(bits);
+      extent = {std::min<int64_t>(extent.minX, bit % 8), std::min<int64_t>(extent.minY, bit / 8),
+                std::max<int64_t>(extent.maxX, bit % 8), std::max<int64_t>(extent.maxY, bit / 8)};
+    }
+  } else {
+    const int64_t half = int64_t{1} << (node->level - 1);
+    const Node* children[4] = {node->nw, node->ne, node->sw, node->se};
+    for (int i = 0; i < 4; ++i) {
+      if (children[i]->population == 0) continue;
+      const Extent child = Bounds(children[i], extents);
+      const int64_t x = (i % 2) * half;
+      const int64_t y = (i / 2) * half;
+      extent = {std::min(extent.minX, x + child.minX), std::min(extent.minY, y + child.minY),
+                std::max(extent.maxX, x + child.maxX), std::max(extent.maxY, y + child.maxY)};
+    }
+  }
+  extents->emplace(node, extent);
+  return extent;
+}
+
+Quadtree HashLifeEngine::Snapshot() const {
+  Quadtree tree(1);
+  std::unordered_map<const Node*, uint32_t> indices;
+  if (SnapshotNode(root_, &indices, &tree) == 0) tree.push_back(QuadtreeNode{});
+  return tree;
+}
+
+uint32_t HashLifeEngine::SnapshotNode(const Node* node, std::unordered_map<const Node*, uint32_t>* indices,
+                                      Quadtree* tree) {
+  if (node->population == 0) return 0;
+  const auto found = indices->find(node);
+  if (found != indices->end()) return found->second;
+  QuadtreeNode entry;
+  entry.level = node->level;
+  if (node->level == kLeafLevel) {
+    entry.bits = node->bits;
+  } else {
+    entry.nw = SnapshotNode(node->nw, indices, tree);
+    entry.ne = SnapshotNode(node->ne, indices, tree);
+    entry.sw = SnapshotNode(node->sw, indices, tree);
+    entry.se = SnapshotNode(node->se, indices, tree);
+  }
+  tree->push_back(entry);
+  const uint32_t index = static_cast<uint32_t>(tree->size() - 1);
+  indices->emplace(node, index);
+  return index;
+}
+
+void HashLifeEngine::Expand() {
+  Node* empty = Empty(root_->level - 1);
+  root_ = Join(Join(empty, empty, empty, root_->nw), Join(empty, empty, root_->ne, empty),
+               Join(empty, root_->sw, empty, empty), Join(root_->se, empty, empty, empty));
+  const int64_t offset = int64_t{1} << (root_->level - 2);
+  rootX_ -= offset;
+  rootY_ -= offset;
+}
+
+void HashLifeEngine::Insert(Node* node) {
+  if (nodeCount_ > buckets_.size()) Rehash(buckets_.size() * 2);
+  const size_t hash = node->level == kLeafLevel ? HashLeaf(node->bits)
+                                                : HashChildren(node->nw, node->ne, node->sw, node->se);
+  Node*& bucket = buckets_[hash & (buckets_.size() - 1)];
+  node->next = bucket;
+  bucket = node;
+}
+
+void HashLifeEngine::Rehash(size_t bucketCount) {
+  std::vector<Node*> old(bucketCount, nullptr);
+  old.swap(buckets_);
+  for (Node* chain : old) {
+    while (chain != nullptr) {
+      Node* node = chain;
+      chain = chain->next;
+      const size_t hash = node->level == kLeafLevel ? HashLeaf(node->bits)
+                                                    : HashChildren(node->nw, node->ne, node->sw, node->se);
+      Node*& bucket = buckets_[hash & (bucketCount - 1)];
+      node->next = bucket;
+      bucket = node;
+    }
+  }
+}
+
+void HashLifeEngine::Mark(Node* node) {
+  if (node == nullptr || node->marked) return;
+  node->marked = true;
+  if (node->level > kLeafLevel) {
+    Mark(node->nw);
+    Mark(node->ne);
+    Mark(node->sw);
+    Mark(node->se);
+  }
+}
+
+void HashLifeEngine::MaybeCollectGarbage() {
+  if (MemoryUsage() <= collectionThreshold_) return;
+  CollectGarbage();
+  // When the nodes still in use fill more than half the budget, let them double before collecting again rather than
+  // collecting on every evaluation
+  collectionThreshold_ = std::max(options_.memoryBudgetBytes, 2 * MemoryUsage());
+}
+
+void HashLifeEngine::CollectGarbage() {
+  Mark(root_);
+  for (Node* node : empty_) Mark(node);
+  for (Node* node : pinned_) Mark(node);
+
+  // Survivors drop memoized results that are about to be freed, then everything unmarked goes back on the free list
+  for (Node* chain : buckets_) {
+    for (Node* node = chain; node != nullptr; node = node->next) {
+      if (node->marked && node->result != nullptr && !node->result->marked) node->result = nullptr;
+    }
+  }
+  for (Node*& chain : buckets_) {
+    Node** link = &chain;
+    while (*link != nullptr) {
+      Node* node = *link;
+      if (node->marked) {
+        node->marked = false;
+        link = &node->next;
+      } else {
+        *link = node->next;
+        node->next = freeList_;
+        freeList_ = node;
+        --nodeCount_;
+      }
+    }
+  }
+  ++garbageCollections_;
+}
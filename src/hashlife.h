@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "board.h"
+#include "engine.h"
+#include "rule.h"
+
+struct HashLifeOptions {
+  // Soft limit on memory held by quadtree nodes and their hash table, checked before every RESULT evaluation, even deep
+  // inside a single large jump. Once it is exceeded, every node not reachable from the current universe or from the
+  // evaluations in progress (mostly memoized intermediate results) is freed. It is a trigger rather than a cap:
+  //  - When the nodes still needed take more than half the budget, the next collection waits until use doubles, so
+  //    use can overshoot to twice the live set, and past the budget, rather than collecting on every evaluation.
+  //  - Freed nodes are recycled rather than returned to the system, so the process keeps its peak footprint.
+  size_t memoryBudgetBytes = size_t{512} << 20;
+  // Rules with B0 are not supported: they would fill the infinite empty plane
+  Rule rule = kConwayRule;
+};
+
+// Quadtree laid out the way Macrocell files store it (see macrocell_file.h): nodes refer to their children by index,
+// children come before their parents and the last node is the root. Index 0 stands for an empty child of any size, so
+// entry 0 itself is unused.
+struct QuadtreeNode {
+  // 3 for 8x8 leaves, which hold row r of their cells in byte r of `bits`, column c in bit c of that byte
+  int level = 3;
+  uint64_t bits = 0;
+  uint32_t nw = 0;
+  uint32_t ne = 0;
+  uint32_t sw = 0;
+  uint32_t se = 0;
+};
+using Quadtree = std::vector<QuadtreeNode>;
+
+// Gosper's HashLife. The universe is a quadtree whose nodes are hash-consed, so identical regions anywhere in space or
+// time share one node, and each node memoizes its RESULT: the centre half of the node advanced 2^j generations. A
+// single RESULT evaluation on a level-k node can therefore jump up to 2^(k-2) generations at once.
+//
+// Unlike the packed engine the universe is an unbounded plane rather than a torus. The initial board is placed with
+// its top-left cell at the origin and View() shows the same board-sized window, so patterns leaving the window are
+// still simulated but no longer visible.
+class HashLifeEngine : public Engine {
+ public:
+  static constexpr int kMaxTreeView = 8192;
+
+  HashLifeEngine(const Board& initial, const HashLifeOptions& options);
+  // Starts from a quadtree, shifted so the bounding box of its live cells starts at the origin. View() shows that box,
+  // clipped to kMaxTreeView cells on a side.
+  HashLifeEngine(const Quadtree& tree, const HashLifeOptions& options);
+  ~HashLifeEngine() override;
+
+  HashLifeEngine(const HashLifeEngine&) = delete;
+  HashLifeEngine& operator=(const HashLifeEngine&) = delete;
+
+  const char* Name() const override { return "hashlife"; }
+  void Advance(uint64_t generations) override;
+  uint64_t Generation() const override { return generation_; }
+  uint64_t Population() const override;
+  const Board& View() override;
+  bool ExportBoard(Board* board, std::string* error) override;
+
+  // Advances exactly 2^exponent generations with a single RESULT evaluation on a suitably expanded root
+  void AdvancePowerOfTwo(int exponent);
+
+  // The current universe with every distinct node listed once, so repetitive patterns stay small however large they
+  // are. Positions are relative to the root, so the origin is not preserved.
+  Quadtree Snapshot() const;
+
+  size_t NodeCount() const { return nodeCount_; }
+  // Bytes held by live nodes and the hash table. Freed nodes are recycled rather than returned to the system, so the
+  // process footprint tracks the peak of this value.
+  size_t MemoryUsage() const;
+  uint64_t GarbageCollections() const { return garbageCollections_; }
+
+ private:
+  struct Node;
+
+  // Leaves are 8x8 blocks (level 3); a level-k node covers 2^k x 2^k cells
+  static constexpr int kLeafLevel = 3;
+
+  Node* Allocate();
+  Node* Leaf(uint64_t bits);
+  Node* Join(Node* nw, Node* ne, Node* sw, Node* se);
+  Node* Empty(int level);
+  Node* Centered(Node* node);
+  Node* Result(Node* node, int step);
+  Node* LeafResult(Node* node, int generations);
+  Node* Build(const Board& board, int level, int64_t x, int64_t y);
+  void Render(const Node* node, int64_t x, int64_t y, Board* out) const;
+  // Bounding box of a node's live cells relative to its top-left corner
+  struct Extent {
+    int64_t minX, minY, maxX, maxY;
+  };
+  static Extent Bounds(const Node* node, std::unordered_map<const Node*, Extent>* extents);
+  static uint32_t SnapshotNode(const Node* node, std::unordered_map<const Node*, uint32_t>* indices, Quadtree* tree);
+  void Expand();
+  void Insert(Node* node);
+  void Rehash(size_t bucketCount);
+  // Collects once memory use passes the next threshold. Only safe where every node still needed is reachable from
+  // the root or pinned_.
+  void MaybeCollectGarbage();
+  void CollectGarbage();
+  static void Mark(Node* node);
+
+  HashLifeOptions options_;
+  std::vector<std::unique_ptr<Node[]>> blocks_;
+  Node* freeList_ = nullptr;
+  std::vector<Node*> buckets_;
+  std::vector<Node*> empty_;
+  size_t nodeCount_ = 0;
+  uint64_t garbageCollections_ = 0;
+  // Memory use that triggers the next collection: the budget, unless the nodes in use already fill most of it
+  size_t collectionThreshold_ = 0;
+  // Nodes held by RESULT evaluations in progress, which a collection must keep
+  std::vector<Node*> pinned_;
+
+  Node* root_ = nullptr;
+  // World coordinates of the root's top-left cell
+  int64_t rootX_ = 0;
+  int64_t rootY_ = 0;
+  uint64_t generation_ = 0;
+
+  Board view_;
+  uint64_t viewGeneration_ = ~uint64_t{0};
+};
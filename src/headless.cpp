@@ -0,0 +1,199 @@
+// Batch runner: loads a pattern, runs a fixed number of generations as fast as possible and writes the final board
+// plus a JSON stats record. It shares the simulation core with the window build but never touches raylib, so it runs
+// on machines without a display.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "density_pyramid.h"
+#include "engine_config.h"
+#include "hashlife.h"
+#include "macrocell_file.h"
+#include "packed_engine.h"
+#include "png_file.h"
+#include "rle_file.h"
+
+namespace {
+
+const char* const kUsage =
+    "usage: raylib_life_headless [options]\n"
+    "  --pattern=<file>                 starting pattern, PNG, RLE or Macrocell (default: assets/glidergunHD.png);\n"
+    "                                   the file's rule applies unless --rule is given, and Macrocell files run\n"
+    "                                   on hashlife unless --engine is given\n"
+    "  --generations=<n>                generations to run (default: 1000)\n"
+    "  --output=<file>                  write the final board as RLE (.rle), Macrocell (.mc) or PNG; hashlife\n"
+    "                                   and sparse write every live cell, not just the starting window\n"
+    "  --stats=<file.json>              write stats to a file instead of stdout\n";
+
+struct HeadlessConfig {
+  std::string pattern = "assets/glidergunHD.png";
+  uint64_t generations = 1000;
+  std::string output;
+  std::string stats;
+};
+
+// Only ever called with paths and engine/kernel names, but quote them properly anyway
+std::string JsonString(std::string_view text) {
+  std::string quoted = "\"";
+  for (const char c : text) {
+    if (c == '"' || c == '\\') quoted += '\\';
+    if (static_cast<unsigned char>(c) < 0x20) continue;
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+
+bool SaveBoard(const std::string& path, Engine& engine, const std::string& rule, std::string* error) {
+  // HashLife saves its whole universe as it is; the other engines go through their live cells, which on the unbounded
+  // engines may have left the starting window
+  const HashLifeEngine* hashLife = dynamic_cast<const HashLifeEngine*>(&engine);
+  if (hashLife != nullptr && IsMacrocellPath(path)) return SaveMacrocell(path, hashLife->Snapshot(), rule, error);
+  // Macrocell files here hold two states only, and their rule line would bring the dying cells back as dead ones
+  if (engine.StateCount() > 2 && IsMacrocellPath(path)) {
+    *error = path + ": Generations patterns can be saved as RLE or PNG, not Macrocell";
+    return false;
+  }
+  Board board;
+  if (!engine.ExportBoard(&board, error)) {
+    *error = path + ": " + *error;
+    return false;
+  }
+  if (IsRlePath(path)) return SaveRleBoard(path, board, engine.ViewAges(), rule, error);
+  if (!IsMacrocellPath(path)) return SavePngBoard(path, board, error);
+  return SaveMacrocell(path, HashLifeEngine(board, HashLifeOptions{}).Snapshot(), rule, error);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  EngineConfig engineConfig;
+  HeadlessConfig config;
+  bool ruleGiven = false;
+  bool engineGiven = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    std::string error;
+    if (ParseEngineArgument(arg, &engineConfig, &error)) {
+      // Handled, possibly with an error reported below
+      if (arg.starts_with("--rule=")) ruleGiven = true;
+      if (arg.starts_with("--engine=")) engineGiven = true;
+    } else if (arg.starts_with("--pattern=")) {
+      config.pattern = arg.substr(10);
+    } else if (arg.starts_with("--generations=")) {
+      if (!ParseNumber(arg.substr(14), &config.generations)) error = "invalid generation count";
+    } else if (arg.starts_with("--output=")) {
+      config.output = arg.substr(9);
+    } else if (arg.starts_with("--stats=")) {
+      config.stats = arg.substr(8);
+    } else if (arg == "--help") {
+      std::fprintf(stdout, "%s%s", kUsage, kEngineUsage);
+      return 0;
+    } else {
+      error = "unknown argument";
+    }
+    if (!error.empty()) {
+      std::fprintf(stderr, "%s: %s\n%s%s", argv[i], error.c_str(), kUsage, kEngineUsage);
+      return 1;
+    }
+  }
+
+  std::string error;
+  const auto loadStart = std::chrono::steady_clock::now();
+  Board initial;
+  std::vector<Board> initialAges;
+  Quadtree tree;
+  std::string patternRule;
+  const bool macrocell = IsMacrocellPath(config.pattern);
+  bool loaded;
+  if (macrocell) {
+    loaded = LoadMacrocell(config.pattern, &tree, &patternRule, &error);
+  } else if (IsRlePath(config.pattern)) {
+    loaded = LoadRleBoard(config.pattern, &initial, &initialAges, &patternRule, &error);
+  } else {
+    loaded = LoadPngBoard(config.pattern, &initial, &error);
+  }
+  if (!loaded) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  if (!ruleGiven && !patternRule.empty() && !SetConfigRule(patternRule, &engineConfig, &error)) {
+    std::fprintf(stderr, "%s: %s\n", config.pattern.c_str(), error.c_str());
+    return 1;
+  }
+  if (macrocell && !engineGiven) engineConfig.engine = "hashlife";
+
+  const StepKernel* kernel = ResolveKernel(engineConfig, &error);
+  if (kernel == nullptr) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  std::unique_ptr<Engine> engine =
+      macrocell ? CreateEngine(engineConfig, tree, &error)
+                : CreateEngine(engineConfig, std::move(initial), std::move(initialAges), &error);
+  if (engine == nullptr) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  const double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+  // The unbounded engines simulate a plane rather than the board size they were started from, so there is no fixed
+  // number of cells updated per generation, and HashLife steps its leaves without the row kernels
+  const bool bounded = engineConfig.engine == "packed";
+  const bool usesKernel = engineConfig.engine != "hashlife";
+  const int width = engine->View().Width();
+  const int height = engine->View().Height();
+  const PackedEngine* packedEngine = dynamic_cast<const PackedEngine*>(engine.get());
+
+  const auto runStart = std::chrono::steady_clock::now();
+  engine->Advance(config.generations);
+  const double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+  if (!config.output.empty() && !SaveBoard(config.output, *engine, ConfigRuleString(engineConfig), &error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  FILE* statsFile = config.stats.empty() ? stdout : std::fopen(config.stats.c_str(), "w");
+  if (statsFile == nullptr) {
+    std::fprintf(stderr, "%s: could not open for writing\n", config.stats.c_str());
+    return 1;
+  }
+  // How far the final pattern is spread out, as occupied 8x8, 64x64 and 512x512 blocks. The unbounded engines count
+  // over the bounding box of all their live cells, and report null when that is too large to export.
+  std::string occupiedBlocks = "null";
+  Board cells;
+  if (bounded || engine->ExportBoard(&cells, &error)) {
+    const DensityPyramid density(bounded ? engine->View() : cells);
+    occupiedBlocks = "{\"8\": " + std::to_string(density.OccupiedBlocks(3)) + ", \"64\": " +
+                     std::to_string(density.OccupiedBlocks(6)) + ", \"512\": " +
+                     std::to_string(density.OccupiedBlocks(9)) + "}";
+  }
+  const double cellUpdates = static_cast<double>(width) * height * static_cast<double>(config.generations);
+  // Fields that do not apply to the engine are null
+  char cellUpdateRate[32] = "null";
+  if (bounded) {
+    std::snprintf(cellUpdateRate, sizeof(cellUpdateRate), "%.1f", runSeconds > 0 ? cellUpdates / runSeconds : 0.0);
+  }
+  const std::string kernelName = usesKernel ? JsonString(kernel->name) : "null";
+  const std::string widthText = bounded ? std::to_string(width) : "null";
+  const std::string heightText = bounded ? std::to_string(height) : "null";
+  std::fprintf(statsFile,
+               "{\"pattern\": %s, \"engine\": %s, \"rule\": %s, \"kernel\": %s, \"threads\": %d, \"width\": %s, "
+               "\"height\": %s, "
+               "\"generations\": %llu, \"population\": %llu, \"load_seconds\": %.6f, \"run_seconds\": %.6f, "
+               "\"generations_per_second\": %.1f, \"cell_updates_per_second\": %s, \"occupied_blocks\": %s}\n",
+               JsonString(config.pattern).c_str(), JsonString(engine->Name()).c_str(),
+               JsonString(ConfigRuleString(engineConfig)).c_str(), kernelName.c_str(),
+               packedEngine ? packedEngine->ThreadCount() : 1, widthText.c_str(), heightText.c_str(),
+               static_cast<unsigned long long>(engine->Generation()),
+               static_cast<unsigned long long>(engine->Population()), loadSeconds, runSeconds,
+               runSeconds > 0 ? config.generations / runSeconds : 0.0, cellUpdateRate, occupiedBlocks.c_str());
+  if (statsFile != stdout) std::fclose(statsFile);
+  return 0;
+}
@@ -0,0 +1,293 @@
+#include "larger_than_life.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+namespace {
+
+char Lower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+bool ParseInt(std::string_view text, int* value) {
+  const char* end = text.data() + text.size();
+  const auto [parsedEnd, errorCode] = std::from_chars(text.data(), end, *value);
+  return !text.empty() && errorCode == std::errc{} && parsedEnd == end;
+}
+
+// "34..58", or a single count
+bool ParseRange(std::string_view text, int* low, int* high) {
+  const size_t dots = text.find("..");
+  if (dots == std::string_view::npos) return ParseInt(text, low) && ParseInt(text, high);
+  return ParseInt(text.substr(0, dots), low) && ParseInt(text.substr(dots + 2), high) && *low <= *high;
+}
+
+int Mod(int value, int modulus) {
+  const int remainder = value % modulus;
+  return remainder < 0 ? remainder + modulus : remainder;
+}
+
+}  // namespace
+
+bool ParseLargerThanLifeRule(std::string_view text, LargerThanLifeRule* rule, std::string* error) {
+  if (text == "bosco") {
+    *rule = LargerThanLifeRule{};
+    return true;
+  }
+  const std::string invalid =
+      "invalid Larger than Life rule '" + std::string(text) + "', expected e.g. R5,C0,M1,S34..58,B34..45,NM";
+  LargerThanLifeRule parsed;
+  bool seenRadius = false;
+  bool seenSurvival = false;
+  bool seenBirth = false;
+  while (!text.empty()) {
+    const size_t comma = text.find(',');
+    const std::string_view part = text.substr(0, comma);
+    text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    if (part.size() < 2) {
+      *error = invalid;
+      return false;
+    }
+    const std::string_view value = part.substr(1);
+    int number = 0;
+    bool valid = false;
+    switch (Lower(part[0])) {
+      case 'r':
+        valid = seenRadius = ParseInt(value, &parsed.radius) && parsed.radius >= 1 &&
+                             parsed.radius <= kMaxLargerThanLifeRadius;
+        break;
+      case 'c':
+        // C0 and C2 both mean two states
+        valid = ParseInt(value, &number) && (number == 0 || number == 2);
+        break;
+      case 'm':
+        valid = ParseInt(value, &number) && (number == 0 || number == 1);
+        parsed.includeCenter = number == 1;
+        break;
+      case 's':
+        valid = seenSurvival = ParseRange(value, &parsed.survivalMin, &parsed.survivalMax);
+        break;
+      case 'b':
+        valid = seenBirth = ParseRange(value, &parsed.birthMin, &parsed.birthMax);
+        break;
+      case 'n':
+        valid = value.size() == 1 && (Lower(value[0]) == 'm' || Lower(value[0]) == 'n');
+        parsed.neighborhood = Lower(value[0]) == 'n' ? Neighborhood::kVonNeumann : Neighborhood::kMoore;
+        break;
+    }
+    if (!valid) {
+      *error = invalid;
+      return false;
+    }
+  }
+  if (!seenRadius || !seenSurvival || !seenBirth) {
+    *error = invalid;
+    return false;
+  }
+  *rule = parsed;
+  return true;
+}
+
+std::string LargerThanLifeRuleString(const LargerThanLifeRule& rule) {
+  return "R" + std::to_string(rule.radius) + ",C0,M" + (rule.includeCenter ? "1" : "0") + ",S" +
+         std::to_string(rule.survivalMin) + ".." + std::to_string(rule.survivalMax) + ",B" +
+         std::to_string(rule.birthMin) + ".." + std::to_string(rule.birthMax) +
+         (rule.neighborhood == Neighborhood::kMoore ? ",NM" : ",NN");
+}
+
+LargerThanLifeEngine::LargerThanLifeEngine(const Board& initial, const LargerThanLifeOptions& options)
+    : options_(options),
+      width_(initial.Width()),
+      height_(initial.Height()),
+      pad_(std::clamp(options.rule.radius, 1, kMaxLargerThanLifeRadius) + 1),
+      paddedWidth_(width_ + 2 * pad_),
+      paddedHeight_(height_ + 2 * pad_),
+      cells_(static_cast<size_t>(paddedWidth_) * paddedHeight_, 0),
+      nextCells_(cells_.size(), 0),
+      view_(width_, height_) {
+  options_.rule.radius = pad_ - 1;
+  for (int y = 0; y < height_; ++y) {
+    uint8_t* row = &cells_[static_cast<size_t>(y + pad_) * paddedWidth_ + pad_];
+    for (int x = 0; x < width_; ++x) row[x] = initial.Get(x, y);
+  }
+  if (options_.rule.neighborhood == Neighborhood::kMoore) {
+    rowSums_.resize(static_cast<size_t>(paddedHeight_) * width_);
+  } else {
+    downRight_.resize(cells_.size());
+    downLeft_.resize(cells_.size());
+  }
+  const int threads = std::clamp(options_.threads, 1, std::max(height_, 1));
+  if (threads > 1) pool_ = std::make_unique<ThreadPool>(threads);
+}
+
+void LargerThanLifeEngine::Advance(uint64_t generations) {
+  for (uint64_t i = 0; i < generations; ++i) Step();
+}
+
+void LargerThanLifeEngine::Step() {
+  if (width_ == 0 || height_ == 0) return;
+  FillPadding();
+  if (options_.rule.neighborhood == Neighborhood::kMoore) {
+    ForEachStripe(paddedHeight_, [this](int begin, int end) { BuildRowSums(begin, end); });
+    ForEachStripe(height_, [this](int begin, int end) { StepMooreRows(begin, end); });
+  } else {
+    BuildDiagonalSums();
+    ForEachStripe(height_, [this](int begin, int end) { StepVonNeumannRows(begin, end); });
+  }
+  std::swap(cells_, nextCells_);
+  ++generation_;
+}
+
+uint64_t LargerThanLifeEngine::Population() const {
+  uint64_t population = 0;
+  for (int y = 0; y < height_; ++y) {
+    const uint8_t* row = &cells_[static_cast<size_t>(y + pad_) * paddedWidth_ + pad_];
+    for (int x = 0; x < width_; ++x) population += row[x];
+  }
+  return population;
+}
+
+const Board& LargerThanLifeEngine::View() {
+  if (viewGeneration_ != generation_) {
+    view_.Clear();
+    for (int y = 0; y < height_; ++y) {
+      const uint8_t* row = &cells_[static_cast<size_t>(y + pad_) * paddedWidth_ + pad_];
+      uint64_t* words = view_.Row(y);
+      for (int x = 0; x < width_; ++x) {
+        words[x / Board::kBitsPerWord] |= static_cast<uint64_t>(row[x]) << (x % Board::kBitsPerWord);
+      }
+    }
+    viewGeneration_ = generation_;
+  }
+  return view_;
+}
+
+void LargerThanLifeEngine::ForEachStripe(int rows, const std::function<void(int, int)>& stepRows) {
+  if (!pool_) {
+    stepRows(0, rows);
+    return;
+  }
+  const int stripeCount = pool_->ThreadCount();
+  pool_->Run([rows, stripeCount, &stepRows](int stripe) {
+    stepRows(static_cast<int>(static_cast<int64_t>(rows) * stripe / stripeCount),
+             static_cast<int>(static_cast<int64_t>(rows) * (stripe + 1) / stripeCount));
+  });
+}
+
+void LargerThanLifeEngine::FillPadding() {
+  // Wrapped copies; the only place that needs a modulo, and only for the 2(R + 1) padding cells of each line
+  for (int py = pad_; py < pad_ + height_; ++py) {
+    uint8_t* row = &cells_[static_cast<size_t>(py) * paddedWidth_];
+    for (int px = 0; px < pad_; ++px) row[px] = row[pad_ + Mod(px - pad_, width_)];
+    for (int px = pad_ + width_; px < paddedWidth_; ++px) row[px] = row[pad_ + Mod(px - pad_, width_)];
+  }
+  for (int py = 0; py < paddedHeight_; ++py) {
+    if (py >= pad_ && py < pad_ + height_) continue;
+    const int source = pad_ + Mod(py - pad_, height_);
+    std::copy_n(&cells_[static_cast<size_t>(source) * paddedWidth_], paddedWidth_,
+                &cells_[static_cast<size_t>(py) * paddedWidth_]);
+  }
+}
+
+uint8_t LargerThanLifeEngine::NextCell(uint8_t cell, int total) const {
+  const LargerThanLifeRule& rule = options_.rule;
+  if (!rule.includeCenter) total -= cell;
+  return cell ? (total >= rule.survivalMin && total <= rule.survivalMax)
+              : (total >= rule.birthMin && total <= rule.birthMax);
+}
+
+void LargerThanLifeEngine::BuildRowSums(int pyBegin, int pyEnd) {
+  const int radius = options_.rule.radius;
+  for (int py = pyBegin; py < pyEnd; ++py) {
+    const uint8_t* row = &cells_[static_cast<size_t>(py) * paddedWidth_ + pad_];
+    int32_t* sums = &rowSums_[static_cast<size_t>(py) * width_];
+    int32_t sum = 0;
+    for (int dx = -radius; dx <= radius; ++dx) sum += row[dx];
+    sums[0] = sum;
+    for (int x = 1; x < width_; ++x) {
+      sum += row[x + radius] - row[x - radius - 1];
+      sums[x] = sum;
+    }
+  }
+}
+
+void LargerThanLifeEngine::StepMooreRows(int yBegin, int yEnd) {
+  if (yBegin >= yEnd) return;
+  const int radius = options_.rule.radius;
+  std::vector<int32_t> totals(width_, 0);
+  auto rowSums = [this](int py) { return &rowSums_[static_cast<size_t>(py) * width_]; };
+  for (int py = yBegin + pad_ - radius; py <= yBegin + pad_ + radius; ++py) {
+    const int32_t* sums = rowSums(py);
+    for (int x = 0; x < width_; ++x) totals[x] += sums[x];
+  }
+  for (int y = yBegin; y < yEnd; ++y) {
+    if (y > yBegin) {
+      const int32_t* entering = rowSums(y + pad_ + radius);
+      const int32_t* leaving = rowSums(y + pad_ - radius - 1);
+      for (int x = 0; x < width_; ++x) totals[x] += entering[x] - leaving[x];
+    }
+    const size_t offset = static_cast<size_t>(y + pad_) * paddedWidth_ + pad_;
+    const uint8_t* row = &cells_[offset];
+    uint8_t* out = &nextCells_[offset];
+    for (int x = 0; x < width_; ++x) out[x] = NextCell(row[x], totals[x]);
+  }
+}
+
+void LargerThanLifeEngine::BuildDiagonalSums() {
+  for (int py = 0; py < paddedHeight_; ++py) {
+    const size_t offset = static_cast<size_t>(py) * paddedWidth_;
+    const uint8_t* row = &cells_[offset];
+    int32_t* downRight = &downRight_[offset];
+    int32_t* downLeft = &downLeft_[offset];
+    if (py == 0) {
+      std::copy_n(row, paddedWidth_, downRight);
+      std::copy_n(row, paddedWidth_, downLeft);
+      continue;
+    }
+    const int32_t* downRightAbove = downRight - paddedWidth_;
+    const int32_t* downLeftAbove = downLeft - paddedWidth_;
+    downRight[0] = row[0];
+    for (int px = 1; px < paddedWidth_; ++px) downRight[px] = row[px] + downRightAbove[px - 1];
+    for (int px = 0; px < paddedWidth_ - 1; ++px) downLeft[px] = row[px] + downLeftAbove[px + 1];
+    downLeft[paddedWidth_ - 1] = row[paddedWidth_ - 1];
+  }
+}
+
+void LargerThanLifeEngine::StepVonNeumannRows(int yBegin, int yEnd) {
+  if (yBegin >= yEnd) return;
+  const int radius = options_.rule.radius;
+  const int stride = paddedWidth_;
+  // downRight_ accumulates towards the lower right, downLeft_ towards the lower left, so the sum of a diagonal segment
+  // is the prefix at its lower end minus the prefix just beyond its upper end
+  auto downRight = [this, stride](int px, int py) { return downRight_[static_cast<size_t>(py) * stride + px]; };
+  auto downLeft = [this, stride](int px, int py) { return downLeft_[static_cast<size_t>(py) * stride + px]; };
+
+  // The stripe's first row is summed directly, one horizontal run per row of the diamond, from row prefix sums
+  std::vector<int32_t> totals(width_, 0);
+  std::vector<int32_t> prefix(paddedWidth_ + 1);
+  for (int dy = -radius; dy <= radius; ++dy) {
+    const uint8_t* row = &cells_[static_cast<size_t>(yBegin + pad_ + dy) * stride];
+    for (int px = 0; px < paddedWidth_; ++px) prefix[px + 1] = prefix[px] + row[px];
+    const int reach = radius - std::abs(dy);
+    for (int x = 0; x < width_; ++x) totals[x] += prefix[x + pad_ + reach + 1] - prefix[x + pad_ - reach];
+  }
+
+  for (int y = yBegin; y < yEnd; ++y) {
+    const size_t offset = static_cast<size_t>(y + pad_) * stride + pad_;
+    const uint8_t* row = &cells_[offset];
+    uint8_t* out = &nextCells_[offset];
+    for (int x = 0; x < width_; ++x) out[x] = NextCell(row[x], totals[x]);
+    if (y + 1 == yEnd) break;
+
+    // Slide every diamond one row down: add the lower edge of the diamond centred on (cx, cy + 1), drop the upper
+    // edge of the one centred on (cx, cy)
+    const int cy = y + pad_;
+    for (int x = 0; x < width_; ++x) {
+      const int cx = x + pad_;
+      const int32_t lowerLeft = downRight(cx, cy + 1 + radius) - downRight(cx - radius - 1, cy);
+      const int32_t lowerRight = downLeft(cx + 1, cy + radius) - downLeft(cx + radius + 1, cy);
+      const int32_t upperLeft = downLeft(cx - radius, cy) - downLeft(cx + 1, cy - radius - 1);
+      const int32_t upperRight = downRight(cx + radius, cy) - downRight(cx, cy - radius);
+      totals[x] += lowerLeft + lowerRight - upperLeft - upperRight;
+    }
+  }
+}
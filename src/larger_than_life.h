@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "board.h"
+#include "engine.h"
+#include "thread_pool.h"
+
+enum class Neighborhood {
+  kMoore,        // the (2R+1)x(2R+1) square
+  kVonNeumann,   // the diamond |dx| + |dy| <= R
+};
+
+// Larger than Life rule in the usual "R5,C0,M1,S34..58,B34..45,NM" notation: neighborhood radius R, whether the cell
+// itself counts towards its neighbor total (M), and inclusive survival and birth ranges for that total. Only
+// two-state rules (C0 or C2) are supported.
+struct LargerThanLifeRule {
+  int radius = 5;
+  bool includeCenter = true;
+  Neighborhood neighborhood = Neighborhood::kMoore;
+  int survivalMin = 34;
+  int survivalMax = 58;
+  int birthMin = 34;
+  int birthMax = 45;
+
+  bool operator==(const LargerThanLifeRule& other) const = default;
+};
+
+constexpr int kMaxLargerThanLifeRadius = 500;
+
+// Also accepts the name bosco for Bosco's rule, the default above
+bool ParseLargerThanLifeRule(std::string_view text, LargerThanLifeRule* rule, std::string* error);
+std::string LargerThanLifeRuleString(const LargerThanLifeRule& rule);
+
+struct LargerThanLifeOptions {
+  LargerThanLifeRule rule;
+  // Worker threads stepping the board; 1 steps everything on the calling thread
+  int threads = 1;
+};
+
+// Larger than Life on a torus. Neighbor totals come from running sums, so each cell costs the same whatever the
+// radius:
+//  - Moore: every row gets a sliding horizontal window sum, and a second sliding window runs down the columns over
+//    those, adding the row entering the square and subtracting the one leaving it.
+//  - von Neumann: prefix sums along both diagonals give the sum of any diagonal segment in O(1). Moving a diamond one
+//    row down adds its new lower edge (two diagonal segments) and drops the old upper edge.
+// Cells live in a byte grid padded by R + 1 cells of wrapped copies on every side, so no inner loop needs a modulo.
+class LargerThanLifeEngine : public Engine {
+ public:
+  LargerThanLifeEngine(const Board& initial, const LargerThanLifeOptions& options);
+
+  const char* Name() const override { return "ltl"; }
+  void Advance(uint64_t generations) override;
+  uint64_t Generation() const override { return generation_; }
+  uint64_t Population() const override;
+  const Board& View() override;
+
+  void Step();
+
+ private:
+  void FillPadding();
+  void StepMooreRows(int yBegin, int yEnd);
+  void StepVonNeumannRows(int yBegin, int yEnd);
+  void BuildRowSums(int pyBegin, int pyEnd);
+  void BuildDiagonalSums();
+  void ForEachStripe(int rows, const std::function<void(int, int)>& stepRows);
+  uint8_t NextCell(uint8_t cell, int total) const;
+
+  LargerThanLifeOptions options_;
+  int width_;
+  int height_;
+  int pad_;
+  int paddedWidth_;
+  int paddedHeight_;
+  std::vector<uint8_t> cells_;
+  std::vector<uint8_t> nextCells_;
+  // Moore: horizontal window sums of every padded row, one entry per board column
+  std::vector<int32_t> rowSums_;
+  // von Neumann: prefix sums along the down-right and down-left diagonals of the padded grid
+  std::vector<int32_t> downRight_;
+  std::vector<int32_t> downLeft_;
+  std::unique_ptr<ThreadPool> pool_;
+  uint64_t generation_ = 0;
+
+  Board view_;
+  uint64_t viewGeneration_ = ~uint64_t{0};
+};
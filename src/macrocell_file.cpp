@@ -0,0 +1,196 @@
+#include "macrocell_file.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+constexpr int kLeafLevel = 3;
+// Coordinates are int64_t, so deeper trees could not be placed
+constexpr int kMaxLevel = 62;
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+  return text;
+}
+
+// Splits off the next space-separated number
+bool NextNumber(std::string_view* text, uint64_t* value) {
+  *text = Trim(*text);
+  const char* end = text->data() + text->size();
+  const auto [parsedEnd, errorCode] = std::from_chars(text->data(), end, *value);
+  if (errorCode != std::errc{} || (parsedEnd != end && *parsedEnd != ' ' && *parsedEnd != '\t')) return false;
+  text->remove_prefix(static_cast<size_t>(parsedEnd - text->data()));
+  return true;
+}
+
+// Leaf line: row by row, '*' alive and '.' dead, each row ended by '$' with trailing dead cells and rows left out
+bool ParseLeaf(std::string_view line, uint64_t* bits) {
+  *bits = 0;
+  int row = 0;
+  int column = 0;
+  for (const char c : line) {
+    if (c == '$') {
+      ++row;
+      column = 0;
+      continue;
+    }
+    if ((c != '.' && c != '*') || row >= 8 || column >= 8) return false;
+    if (c == '*') *bits |= uint64_t{1} << (row * 8 + column);
+    ++column;
+  }
+  return true;
+}
+
+bool EndsWith(std::string_view path, std::string_view extension) {
+  if (path.size() < extension.size()) return false;
+  return std::equal(extension.begin(), extension.end(), path.end() - extension.size(), [](char a, char b) {
+    return (a >= 'A' && a <= 'Z' ? static_cast<char>(a - 'A' + 'a') : a) == b;
+  });
+}
+
+}  // namespace
+
+bool ParseMacrocell(std::string_view text, Quadtree* tree, std::string* rule, std::string* error) {
+  rule->clear();
+  // Per node line of the file: its level, and either its index in `parsed` (levels 3 and up) or, for the 2x2 and
+  // 4x4 nodes of multi-state files, its cells in the leaf bit layout
+  struct FileNode {
+    int level;
+    uint32_t index;
+    uint64_t bits;
+  };
+  std::vector<FileNode> nodes(1, FileNode{0, 0, 0});
+  Quadtree parsed(1);
+  bool sawHeader = false;
+  int lineNumber = 0;
+  while (!text.empty()) {
+    const size_t newline = text.find('\n');
+    std::string_view line = Trim(text.substr(0, newline));
+    text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+    ++lineNumber;
+    const std::string invalid = "Macrocell line " + std::to_string(lineNumber) + " is invalid";
+    if (!sawHeader) {
+      if (!line.starts_with("[M2]")) {
+        *error = "not a Macrocell file (missing [M2] header)";
+        return false;
+      }
+      sawHeader = true;
+      continue;
+    }
+    if (line.empty()) continue;
+    if (line.front() == '#') {
+      if (line.starts_with("#R")) *rule = Trim(line.substr(2));
+      continue;
+    }
+
+    if (line.front() == '.' || line.front() == '*' || line.front() == '$') {
+      uint64_t bits = 0;
+      if (!ParseLeaf(line, &bits)) {
+        *error = invalid;
+        return false;
+      }
+      parsed.push_back(QuadtreeNode{kLeafLevel, bits});
+      nodes.push_back(FileNode{kLeafLevel, static_cast<uint32_t>(parsed.size() - 1), 0});
+      continue;
+    }
+
+    uint64_t level = 0;
+    uint64_t children[4];
+    bool valid = NextNumber(&line, &level) && level >= 1 && level <= kMaxLevel;
+    for (int i = 0; i < 4 && valid; ++i) valid = NextNumber(&line, &children[i]);
+    valid = valid && Trim(line).empty();
+    if (valid && level == 1) {
+      // Multi-state 2x2 node: the "children" are cell states
+      uint64_t bits = 0;
+      for (int i = 0; i < 4; ++i) bits |= static_cast<uint64_t>(children[i] == 1) << ((i / 2) * 8 + i % 2);
+      nodes.push_back(FileNode{1, 0, bits});
+      continue;
+    }
+    for (int i = 0; i < 4 && valid; ++i) {
+      valid = children[i] < nodes.size() &&
+              (children[i] == 0 || nodes[children[i]].level == static_cast<int>(level) - 1);
+    }
+    if (!valid) {
+      *error = invalid;
+      return false;
+    }
+    if (level <= kLeafLevel) {
+      // Small multi-state nodes assemble into 8x8 leaves
+      const int half = 1 << (level - 1);
+      uint64_t bits = 0;
+      for (int i = 0; i < 4; ++i) bits |= nodes[children[i]].bits << ((i / 2) * half * 8 + (i % 2) * half);
+      if (level < kLeafLevel) {
+        nodes.push_back(FileNode{static_cast<int>(level), 0, bits});
+        continue;
+      }
+      parsed.push_back(QuadtreeNode{kLeafLevel, bits});
+    } else {
+      auto child = [&](int i) { return children[i] == 0 ? 0 : nodes[children[i]].index; };
+      parsed.push_back(QuadtreeNode{static_cast<int>(level), 0, child(0), child(1), child(2), child(3)});
+    }
+    nodes.push_back(FileNode{static_cast<int>(level), static_cast<uint32_t>(parsed.size() - 1), 0});
+  }
+  if (!sawHeader) {
+    *error = "not a Macrocell file (missing [M2] header)";
+    return false;
+  }
+  if (nodes.size() > 1 && nodes.back().level < kLeafLevel) {
+    *error = "Macrocell root is smaller than 8x8";
+    return false;
+  }
+  *tree = std::move(parsed);
+  return true;
+}
+
+bool LoadMacrocell(const std::string& path, Quadtree* tree, std::string* rule, std::string* error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    *error = path + ": could not open";
+    return false;
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  if (!ParseMacrocell(contents.str(), tree, rule, error)) {
+    *error = path + ": " + *error;
+    return false;
+  }
+  return true;
+}
+
+std::string MacrocellFromTree(const Quadtree& tree, std::string_view rule) {
+  std::string out = "[M2] (raylib_life)\n";
+  if (!rule.empty()) out += "#R " + std::string(rule) + "\n";
+  for (size_t i = 1; i < tree.size(); ++i) {
+    const QuadtreeNode& node = tree[i];
+    if (node.level == kLeafLevel) {
+      for (int row = 0; row < 8; ++row) {
+        const uint64_t cells = (node.bits >> (row * 8)) & 0xff;
+        for (int column = 0; column < 8 && (cells >> column) != 0; ++column) out += (cells >> column) & 1 ? '*' : '.';
+        out += '$';
+      }
+    } else {
+      out += std::to_string(node.level) + ' ' + std::to_string(node.nw) + ' ' + std::to_string(node.ne) + ' ' +
+             std::to_string(node.sw) + ' ' + std::to_string(node.se);
+    }
+    out += '\n';
+  }
+  return out;
+}
+
+bool SaveMacrocell(const std::string& path, const Quadtree& tree, std::string_view rule, std::string* error) {
+  std::ofstream file(path, std::ios::binary);
+  const std::string contents = MacrocellFromTree(tree, rule);
+  if (!file || !file.write(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+    *error = path + ": could not write Macrocell file";
+    return false;
+  }
+  return true;
+}
+
+bool IsMacrocellPath(std::string_view path) { return EndsWith(path, ".mc"); }
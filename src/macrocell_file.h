@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "hashlife.h"
+
+// Macrocell (.mc) files, Golly's format for HashLife universes: one line per distinct quadtree node, so a huge but
+// repetitive universe saves in kilobytes and loads straight into the hash-consed tree without ever being a Board.
+// Files from Golly's multi-state algorithms load too, with only state 1 counted as alive.
+
+// `rule` receives the "#R" line, or is cleared when there is none
+bool ParseMacrocell(std::string_view text, Quadtree* tree, std::string* rule, std::string* error);
+bool LoadMacrocell(const std::string& path, Quadtree* tree, std::string* rule, std::string* error);
+
+// `rule` may be empty
+std::string MacrocellFromTree(const Quadtree& tree, std::string_view rule);
+bool SaveMacrocell(const std::string& path, const Quadtree& tree, std::string_view rule, std::string* error);
+
+// Whether `path` names a Macrocell file, judging by its extension
+bool IsMacrocellPath(std::string_view path);
@@ -1,40 +1,209 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "board_image.h"
+#include "board_renderer.h"
+#include "engine_config.h"
+#include "macrocell_file.h"
+#include "packed_engine.h"
 #include "raylib.h"
+#include "rle_file.h"
+#include "simulation_thread.h"
+#include "viewport.h"
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
 
-inline bool ColorsAreEqual(const Color& c1, const Color& c2) {
-  return c1.a == c2.a && c1.b == c2.b && c1.g == c2.g && c1.r == c2.r;
+const char* const kUsage =
+    "usage: raylib_life [options]\n"
+    "  --pattern=<file>                 starting pattern, PNG, RLE or Macrocell (default: assets/glidergunHD.png);\n"
+    "                                   the file's rule applies unless --rule is given, and Macrocell files run\n"
+    "                                   on hashlife unless --engine is given\n"
+    "  --window=<w>x<h>                 window size in pixels (default: 1280x800)\n"
+    "  --fps=<n>                        frame rate cap, 0 for unlimited (default: 60)\n"
+    "  --rate=<gen/s>                   simulation speed independent of the frame rate, 0 for as fast as possible\n"
+    "                                   (default: one batch per frame at 60 frames/s)\n"
+    "  --jump=<k>                       advance in batches of 2^k generations\n"
+    "  --generations=<n>                stop stepping at generation n\n"
+    "  --benchmark[=<n>]                time n generations on the packed engine at 1, 2, 4, ... threads and exit\n";
+
+void LogSchedulerStats(const PackedEngine& engine) {
+  const std::vector<WorkerStats> stats = engine.SchedulerStats();
+  for (size_t worker = 0; worker < stats.size(); ++worker) {
+    TraceLog(LOG_INFO, "LIFE:     worker %2zu: %10llu tiles, %10llu stolen", worker,
+             static_cast<unsigned long long>(stats[worker].tilesProcessed),
+             static_cast<unsigned long long>(stats[worker].tilesStolen));
+  }
 }
 
-inline bool ColorsEqualAlpha(const Color& c1, const Color& c2) { return c1.a == c2.a; }
+// Steps `generations` generations of `initial` with 1, 2, 4, ... up to options.threads worker threads and logs the
+// throughput of each, so multi-core scaling can be measured without opening a window
+void RunBenchmark(const Board& initial, PackedEngineOptions options, int generations) {
+  const double cells = static_cast<double>(initial.Width()) * initial.Height();
+  const int maxThreads = options.threads;
+  for (int threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+    options.threads = threads;
+    PackedEngine engine(initial, options);
+    const auto start = std::chrono::steady_clock::now();
+    engine.Step(generations);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TraceLog(LOG_INFO, "LIFE: %2d threads: %8.0f gen/s, %7.2f Gcell/s", engine.ThreadCount(), generations / seconds,
+             cells * generations / seconds * 1e-9);
+    LogSchedulerStats(engine);
+    if (threads == maxThreads) break;
+  }
+}
 
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void) {
+int main(int argc, char** argv) {
   // Initialization
   //--------------------------------------------------------------------------------------
-  const int screenWidth = 1280;
-  const int screenHeight = 800;
+  // Flags are listed in kUsage and kEngineUsage
+  EngineConfig config;
+  int jumpExponent = 0;
+  double rate = -1;
+  int benchmarkGenerations = 0;
+  std::string patternPath = "assets/glidergunHD.png";
+  int screenWidth = 1280;
+  int screenHeight = 800;
+  int targetFps = 60;
+  uint64_t generationLimit = UINT64_MAX;
+  bool ruleGiven = false;
+  bool engineGiven = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    std::string error;
+    uint64_t number = 0;
+    if (ParseEngineArgument(arg, &config, &error)) {
+      // Handled, possibly with an error reported below
+      if (arg.starts_with("--rule=")) ruleGiven = true;
+      if (arg.starts_with("--engine=")) engineGiven = true;
+    } else if (arg.starts_with("--pattern=")) {
+      patternPath = arg.substr(10);
+    } else if (arg.starts_with("--window=")) {
+      if (!ParseDimensions(arg.substr(9), &screenWidth, &screenHeight) || screenWidth > 16384 ||
+          screenHeight > 16384) {
+        error = "invalid window size, expected e.g. 1920x1080";
+      }
+    } else if (arg.starts_with("--fps=")) {
+      if (!ParseNumber(arg.substr(6), &number) || number > 10000) error = "invalid frame rate";
+      targetFps = static_cast<int>(std::min<uint64_t>(number, 10000));
+    } else if (arg.starts_with("--generations=")) {
+      if (!ParseNumber(arg.substr(14), &generationLimit)) error = "invalid generation count";
+    } else if (arg == "--benchmark") {
+      benchmarkGenerations = 1000;
+    } else if (arg.starts_with("--benchmark=")) {
+      if (!ParseNumber(arg.substr(12), &number) || number == 0 || number > 1000000000) {
+        error = "invalid generation count";
+      }
+      benchmarkGenerations = static_cast<int>(number);
+    } else if (arg.starts_with("--jump=")) {
+      if (!ParseNumber(arg.substr(7), &number) || number > 62) error = "invalid jump exponent";
+      jumpExponent = static_cast<int>(number);
+    } else if (arg.starts_with("--rate=")) {
+      if (!ParseNumber(arg.substr(7), &number)) error = "invalid rate";
+      rate = static_cast<double>(number);
+    } else if (arg == "--help") {
+      std::printf("%s%s", kUsage, kEngineUsage);
+      return 0;
+    } else {
+      error = "unknown argument";
+    }
+    if (!error.empty()) {
+      TraceLog(LOG_ERROR, "LIFE: %s: %s\n%s%s", argv[i], error.c_str(), kUsage, kEngineUsage);
+      return 1;
+    }
+  }
+  std::string error;
+  const StepKernel* kernel = ResolveKernel(config, &error);
+  if (kernel == nullptr) {
+    TraceLog(LOG_ERROR, "LIFE: %s", error.c_str());
+    return 1;
+  }
+
+  // The simulation runs on bit-packed boards. RLE files decode straight into one and Macrocell files into HashLife's
+  // quadtree; PNGs exist as an Image only while loading.
+  Board initial;
+  std::vector<Board> initialAges;
+  Quadtree tree;
+  const bool macrocell = IsMacrocellPath(patternPath);
+  if (macrocell || IsRlePath(patternPath)) {
+    std::string patternRule;
+    const bool loaded = macrocell ? LoadMacrocell(patternPath, &tree, &patternRule, &error)
+                                  : LoadRleBoard(patternPath, &initial, &initialAges, &patternRule, &error);
+    if (!loaded || (!ruleGiven && !patternRule.empty() && !SetConfigRule(patternRule, &config, &error))) {
+      TraceLog(LOG_ERROR, "LIFE: %s", error.c_str());
+      return 1;
+    }
+    if (macrocell && !engineGiven) config.engine = "hashlife";
+  } else {
+    const auto decodeStart = std::chrono::steady_clock::now();
+    Image pattern = LoadImage(patternPath.c_str());
+    if (pattern.data == nullptr) {
+      TraceLog(LOG_ERROR, "LIFE: could not load %s", patternPath.c_str());
+      return 1;
+    }
+    const auto importStart = std::chrono::steady_clock::now();
+    initial = BoardFromImage(pattern);
+    const auto importEnd = std::chrono::steady_clock::now();
+    TraceLog(LOG_INFO, "LIFE: Loaded %dx%d pattern: decoded in %.1f ms, converted to a board in %.1f ms", pattern.width,
+             pattern.height, std::chrono::duration<double, std::milli>(importStart - decodeStart).count(),
+             std::chrono::duration<double, std::milli>(importEnd - importStart).count());
+    UnloadImage(pattern);
+  }
+  TraceLog(LOG_INFO, "LIFE: Using %s step kernel", kernel->name);
 
-  const int updateRate = 1;  // every N frames
-  int frameCount = 0;
+  if (benchmarkGenerations > 0) {
+    if (macrocell) initial = HashLifeEngine(tree, HashLifeOptions{}).View();
+    PackedEngineOptions options = config.packed;
+    options.kernel = kernel->ForRule(config.rule);
+    options.rule = config.rule;
+    RunBenchmark(LayOutBoard(config.layout, std::move(initial)), options, benchmarkGenerations);
+    return 0;
+  }
 
   InitWindow(screenWidth, screenHeight, "Raylib Game of Life");
 
-  Image board = LoadImage("assets/glidergunHD.png");
-  const int gameWidth = board.width;
-  const int gameHeight = board.height;
-  const Vector2 origin{0, 0};
-  const Rectangle gameRect{0, 0, static_cast<float>(gameWidth), static_cast<float>(gameHeight)};
-  const Rectangle screenRect{0, 0, screenWidth, screenHeight};
-  Image nextBoard = GenImageColor(gameWidth, gameHeight, BLANK);
+  std::unique_ptr<Engine> engine = macrocell ? CreateEngine(config, tree, &error)
+                                             : CreateEngine(config, std::move(initial), std::move(initialAges), &error);
+  if (engine == nullptr) {
+    TraceLog(LOG_ERROR, "LIFE: %s", error.c_str());
+    CloseWindow();
+    return 1;
+  }
+  PackedEngine* packedEngine = dynamic_cast<PackedEngine*>(engine.get());
+  if (packedEngine != nullptr) TraceLog(LOG_INFO, "LIFE: Stepping with %d threads", packedEngine->ThreadCount());
+  const uint64_t quantum = uint64_t{1} << jumpExponent;
+  // Without a frame cap, batches and publishes are still paced as if at 60 frames/s
+  const int paceFps = targetFps > 0 ? targetFps : 60;
+  if (rate < 0) rate = static_cast<double>(quantum) * paceFps;
+  TraceLog(LOG_INFO, "LIFE: Using %s engine, %.0f generations/s in batches of %llu", engine->Name(), rate,
+           static_cast<unsigned long long>(quantum));
+  // Starts with the whole board in view
+  Viewport viewport(screenWidth, screenHeight, engine->View().Width(), engine->View().Height());
 
   // NOTE: Textures MUST be loaded after Window initialization (OpenGL context
   // is required)
-  Texture2D boardTexture = LoadTextureFromImage(board);
+  // Live/dead color pairs, cycled with P. Only the shader uniforms change; the board texture stays as it is.
+  const Color palettes[][2] = {{PURPLE, BLANK}, {RAYWHITE, BLACK}, {LIME, DARKGREEN}, {BLACK, RAYWHITE}};
+  const int paletteCount = sizeof(palettes) / sizeof(palettes[0]);
+  int palette = 0;
+  // A few threads expand large uploads; more would mostly compete with the simulation
+  BoardRenderer renderer(screenWidth, screenHeight, palettes[palette][0], palettes[palette][1], engine->StateCount(),
+                         std::min(ThreadPool::DefaultThreadCount(), 4));
+
+  // From here on the engine belongs to the simulation thread until Stop()
+  SimulationThread simulation(engine.get(), rate, quantum, 1.0 / paceFps, generationLimit);
 
-  SetTargetFPS(60);  // Set our game to run at 60 frames-per-second
+  SetTargetFPS(targetFps);  // 0 leaves the frame rate uncapped
   //--------------------------------------------------------------------------------------
 
   // Main game loop
@@ -42,36 +211,32 @@ int main(void) {
   {
     // Update
     //----------------------------------------------------------------------------------
-    // Game of life logic here:
-    // For each location on the board, count the number of neighbors
-    for (size_t x = 0; x < gameWidth; ++x) {
-      for (size_t y = 0; y < gameHeight; ++y) {
-        const int left = ((x - 1) + gameWidth) % gameWidth;
-        const int right = ((x + 1) + gameWidth) % gameWidth;
-        const int above = ((y - 1) + gameHeight) % gameHeight;
-        const int below = ((y + 1) + gameHeight) % gameHeight;
-        int neighbors = 0;
-        bool aliveNextFrame = false;
-
-        if (!ColorsEqualAlpha(GetImageColor(board, left, above), BLANK)) ++neighbors;
-        if (!ColorsEqualAlpha(GetImageColor(board, x, above), BLANK)) ++neighbors;
-        if (!ColorsEqualAlpha(GetImageColor(board, right, above), BLANK)) ++neighbors;
-        if (!ColorsEqualAlpha(GetImageColor(board, left, y), BLANK)) ++neighbors;
-        if (!ColorsEqualAlpha(GetImageColor(board, right, y), BLANK)) ++neighbors;
-        if (!ColorsEqualAlpha(GetImageColor(board, left, below), BLANK)) ++neighbors;
-        if (!ColorsEqualAlpha(GetImageColor(board, x, below), BLANK)) ++neighbors;
-        if (!ColorsEqualAlpha(GetImageColor(board, right, below), BLANK)) ++neighbors;
-
-        if (!ColorsEqualAlpha(GetImageColor(board, x, y), BLANK)) {
-          // If current cell is alive, it lives next frame if it has 2 or 3
-          // neighbors
-          aliveNextFrame = neighbors == 2 || neighbors == 3;
-        } else {
-          // Dead cells come back to life if they have exactly 3 live
-          // neighbors
-          aliveNextFrame = neighbors == 3;
-        }
-        ImageDrawPixel(&nextBoard, x, y, aliveNextFrame ? PURPLE : BLANK);
+    // Game of life logic runs on the simulation thread; the frame shows the newest generation it has published and
+    // only re-uploads when that changed. +/- double or halve a limited rate.
+    if (IsKeyPressed(KEY_EQUAL) && simulation.Rate() > 0) simulation.SetRate(simulation.Rate() * 2);
+    if (IsKeyPressed(KEY_MINUS) && simulation.Rate() > 0) simulation.SetRate(std::max(simulation.Rate() / 2, 1.0));
+    bool fresh = false;
+    const SimulationFrame& frame = simulation.Latest(&fresh);
+    if (IsKeyPressed(KEY_P)) {
+      palette = (palette + 1) % paletteCount;
+      renderer.SetPalette(palettes[palette][0], palettes[palette][1]);
+    }
+    // The mouse wheel zooms around the cursor, dragging or the arrow keys pan and Home fits the board to the window
+    const float wheel = GetMouseWheelMove();
+    if (wheel != 0) viewport.ZoomAt(std::pow(1.25f, wheel), GetMousePosition());
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) viewport.Pan(GetMouseDelta());
+    const float panStep = 400.0f * GetFrameTime();
+    viewport.Pan(Vector2{(IsKeyDown(KEY_LEFT) - IsKeyDown(KEY_RIGHT)) * panStep,
+                         (IsKeyDown(KEY_UP) - IsKeyDown(KEY_DOWN)) * panStep});
+    if (IsKeyPressed(KEY_HOME)) viewport.Fit();
+    // S saves the generation on screen, dying cells included, as snapshot.rle
+    if (IsKeyPressed(KEY_S)) {
+      std::string error;
+      if (SaveRleBoard("snapshot.rle", frame.board, frame.ages, ConfigRuleString(config), &error)) {
+        TraceLog(LOG_INFO, "LIFE: Saved generation %llu to snapshot.rle",
+                 static_cast<unsigned long long>(frame.generation));
+      } else {
+        TraceLog(LOG_ERROR, "LIFE: %s", error.c_str());
       }
     }
 
@@ -81,15 +246,15 @@ int main(void) {
 
     ClearBackground(RAYWHITE);
 
-    UpdateTexture(boardTexture, nextBoard.data);
-    DrawTexturePro(boardTexture, gameRect, screenRect, origin, 0.0f, WHITE);
-
-    DrawFPS(10, 780);
+    // Uploads only when the generation or the visible region changed
+    renderer.Update(frame.board, frame.ages, frame.density, viewport, fresh);
+    renderer.Draw();
 
-    // Swap boards
-    auto temp = board;
-    board = nextBoard;
-    nextBoard = temp;
+    DrawFPS(10, screenHeight - 20);
+    DrawText(TextFormat("gen %llu, pop %llu, %.0f gen/s, zoom %.3gx", static_cast<unsigned long long>(frame.generation),
+                        static_cast<unsigned long long>(frame.density.Population()), frame.generationsPerSecond,
+                        viewport.Zoom()),
+             100, screenHeight - 20, 20, DARKGRAY);
 
     EndDrawing();
     //----------------------------------------------------------------------------------
@@ -97,6 +262,8 @@ int main(void) {
 
   // De-Initialization
   //--------------------------------------------------------------------------------------
+  simulation.Stop();
+  if (packedEngine != nullptr) LogSchedulerStats(*packedEngine);
   CloseWindow();  // Close window and OpenGL context
   //--------------------------------------------------------------------------------------
 
@@ -0,0 +1,253 @@
+// Microbenchmark of the torus wrap: steps the same soup with four traversals and reports each one's cost per cell.
+//   cells_modulo   one byte per cell, x in the outer loop and y in the inner one, neighbors found with % width and
+//                  % height: the original per-cell loop
+//   cells_ghost    one byte per cell with a one-cell ghost border refreshed every generation, walked row by row
+//   words_wrapped  packed Board stepped by StepBoard, which special-cases the first and last word and row
+//   words_padded   PaddedBoard with ghost words and rows, every word stepped by the interior kernel
+// All four run Conway's rule on one thread and must agree on the final board.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "engine_config.h"
+#include "padded_board.h"
+#include "step.h"
+
+namespace {
+
+const char* const kUsage =
+    "usage: raylib_life_microbench [options]\n"
+    "  --sizes=<w>x<h>,...              boards to step (default: 64x4096,1280x800,4096x4096)\n"
+    "  --kernel=<name>                  step kernel for the packed traversals (default: fastest available)\n"
+    "  --min-seconds=<s>                minimum timed run per case (default: 0.5)\n"
+    "  --output=<file.json>             write the report to a file instead of stdout\n";
+
+// One byte per cell, 0 or 1
+class CellGrid {
+ public:
+  CellGrid(int width, int height, int border)
+      : width_(width), height_(height), border_(border), stride_(width + 2 * border),
+        cells_(static_cast<size_t>(stride_) * (height + 2 * border), 0) {}
+
+  uint8_t* Row(int y) { return cells_.data() + static_cast<size_t>(y + border_) * stride_ + border_; }
+  const uint8_t* Row(int y) const { return cells_.data() + static_cast<size_t>(y + border_) * stride_ + border_; }
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+
+ private:
+  int width_;
+  int height_;
+  int border_;
+  int stride_;
+  std::vector<uint8_t> cells_;
+};
+
+CellGrid GridFromBoard(const Board& board, int border) {
+  CellGrid grid(board.Width(), board.Height(), border);
+  for (int y = 0; y < board.Height(); ++y) {
+    for (int x = 0; x < board.Width(); ++x) grid.Row(y)[x] = board.Get(x, y);
+  }
+  return grid;
+}
+
+Board BoardFromGrid(const CellGrid& grid) {
+  Board board(grid.Width(), grid.Height());
+  for (int y = 0; y < grid.Height(); ++y) {
+    for (int x = 0; x < grid.Width(); ++x) board.Set(x, y, grid.Row(y)[x] != 0);
+  }
+  return board;
+}
+
+inline uint8_t NextCell(uint8_t alive, int neighbors) { return neighbors == 3 || (alive && neighbors == 2); }
+
+void StepModulo(const CellGrid& src, CellGrid* dst) {
+  const int width = src.Width();
+  const int height = src.Height();
+  for (int x = 0; x < width; ++x) {
+    for (int y = 0; y < height; ++y) {
+      const int left = (x + width - 1) % width;
+      const int right = (x + 1) % width;
+      const int above = (y + height - 1) % height;
+      const int below = (y + 1) % height;
+      const int neighbors = src.Row(above)[left] + src.Row(above)[x] + src.Row(above)[right] + src.Row(y)[left] +
+                            src.Row(y)[right] + src.Row(below)[left] + src.Row(below)[x] + src.Row(below)[right];
+      dst->Row(y)[x] = NextCell(src.Row(y)[x], neighbors);
+    }
+  }
+}
+
+void RefreshGhostCells(CellGrid* grid) {
+  const int width = grid->Width();
+  const int height = grid->Height();
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = grid->Row(y);
+    row[-1] = row[width - 1];
+    row[width] = row[0];
+  }
+  std::copy(grid->Row(height - 1) - 1, grid->Row(height - 1) + width + 1, grid->Row(-1) - 1);
+  std::copy(grid->Row(0) - 1, grid->Row(0) + width + 1, grid->Row(height) - 1);
+}
+
+void StepGhost(CellGrid* src, CellGrid* dst) {
+  RefreshGhostCells(src);
+  const int width = src->Width();
+  for (int y = 0; y < src->Height(); ++y) {
+    const uint8_t* above = src->Row(y - 1);
+    const uint8_t* row = src->Row(y);
+    const uint8_t* below = src->Row(y + 1);
+    uint8_t* out = dst->Row(y);
+    for (int x = 0; x < width; ++x) {
+      const int neighbors = above[x - 1] + above[x] + above[x + 1] + row[x - 1] + row[x + 1] + below[x - 1] +
+                            below[x] + below[x + 1];
+      out[x] = NextCell(row[x], neighbors);
+    }
+  }
+}
+
+// Generations every traversal runs from the soup before the boards are compared
+constexpr int kCheckGenerations = 16;
+
+// Doubles the batch until a single timed run lasts long enough to trust; returns seconds per generation
+double TimeSteps(const std::function<void()>& step, double minSeconds) {
+  uint64_t batch = 1;
+  while (true) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < batch; ++i) step();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (seconds >= minSeconds || batch >= (uint64_t{1} << 24)) return seconds / static_cast<double>(batch);
+    batch *= 2;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  EngineConfig engineConfig;
+  std::vector<std::pair<int, int>> sizes = {{64, 4096}, {1280, 800}, {4096, 4096}};
+  double minSeconds = 0.5;
+  std::string output;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    std::string error;
+    if (arg.starts_with("--kernel=")) {
+      ParseEngineArgument(arg, &engineConfig, &error);
+    } else if (arg.starts_with("--sizes=")) {
+      sizes.clear();
+      std::string_view list = arg.substr(8);
+      while (!list.empty() && error.empty()) {
+        const size_t comma = list.find(',');
+        int width = 0;
+        int height = 0;
+        if (!ParseDimensions(list.substr(0, comma), &width, &height)) error = "invalid board size";
+        sizes.emplace_back(width, height);
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+      }
+    } else if (arg.starts_with("--min-seconds=")) {
+      minSeconds = std::strtod(std::string(arg.substr(14)).c_str(), nullptr);
+      if (!(minSeconds > 0)) error = "invalid duration";
+    } else if (arg.starts_with("--output=")) {
+      output = arg.substr(9);
+    } else if (arg == "--help") {
+      std::fputs(kUsage, stdout);
+      return 0;
+    } else {
+      error = "unknown argument";
+    }
+    if (!error.empty()) {
+      std::fprintf(stderr, "%s: %s\n%s", argv[i], error.c_str(), kUsage);
+      return 1;
+    }
+  }
+
+  std::string error;
+  const StepKernel* kernel = ResolveKernel(engineConfig, &error);
+  if (kernel == nullptr) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  const RowKernel rowKernel = kernel->ForRule(kConwayRule);
+
+  std::string report = "{\n  \"kernel\": \"" + std::string(kernel->name) + "\",\n  \"results\": [";
+  bool first = true;
+  for (const auto& [width, height] : sizes) {
+    const Board soup = RandomBoard(width, height, 0.3, 1);
+
+    CellGrid moduloCells = GridFromBoard(soup, 0);
+    CellGrid moduloNext(width, height, 0);
+    CellGrid ghostCells = GridFromBoard(soup, 1);
+    CellGrid ghostNext(width, height, 1);
+    Board wrapped = soup;
+    Board wrappedNext(width, height);
+    PaddedBoard padded(soup);
+    PaddedBoard paddedNext(width, height);
+    const std::pair<const char*, std::function<void()>> traversals[] = {
+        {"cells_modulo",
+         [&] {
+           StepModulo(moduloCells, &moduloNext);
+           std::swap(moduloCells, moduloNext);
+         }},
+        {"cells_ghost",
+         [&] {
+           StepGhost(&ghostCells, &ghostNext);
+           std::swap(ghostCells, ghostNext);
+         }},
+        {"words_wrapped",
+         [&] {
+           StepBoard(rowKernel, kConwayRule, wrapped, &wrappedNext);
+           std::swap(wrapped, wrappedNext);
+         }},
+        {"words_padded",
+         [&] {
+           padded.RefreshGhosts();
+           StepPaddedRows(rowKernel, kConwayRule, padded, &paddedNext, 0, height, 0, padded.WordsPerRow());
+           std::swap(padded, paddedNext);
+         }},
+    };
+
+    // Check the traversals against each other before timing them
+    for (int generation = 0; generation < kCheckGenerations; ++generation) {
+      for (const auto& traversal : traversals) traversal.second();
+    }
+    Board paddedBoard;
+    padded.CopyTo(&paddedBoard);
+    if (!(BoardFromGrid(moduloCells) == wrapped) || !(BoardFromGrid(ghostCells) == wrapped) ||
+        !(paddedBoard == wrapped)) {
+      std::fprintf(stderr, "%dx%d: traversals disagree after %d generations\n", width, height, kCheckGenerations);
+      return 1;
+    }
+
+    double moduloSeconds = 0;
+    for (const auto& [name, step] : traversals) {
+      const double seconds = TimeSteps(step, minSeconds);
+      if (moduloSeconds == 0) moduloSeconds = seconds;
+      const double nsPerCell = seconds * 1e9 / (static_cast<double>(width) * height);
+      char line[512];
+      std::snprintf(line, sizeof(line),
+                    "%s\n    {\"width\": %d, \"height\": %d, \"traversal\": \"%s\", \"ns_per_generation\": %.1f, "
+                    "\"ns_per_cell\": %.4f, \"speedup_over_modulo\": %.2f}",
+                    first ? "" : ",", width, height, name, seconds * 1e9, nsPerCell, moduloSeconds / seconds);
+      report += line;
+      first = false;
+      std::fprintf(stderr, "%5dx%-5d %-14s %10.4f ns/cell %8.1fx\n", width, height, name, nsPerCell,
+                   moduloSeconds / seconds);
+    }
+  }
+  report += "\n  ]\n}\n";
+
+  FILE* out = output.empty() ? stdout : std::fopen(output.c_str(), "w");
+  if (out == nullptr) {
+    std::fprintf(stderr, "%s: could not open for writing\n", output.c_str());
+    return 1;
+  }
+  std::fputs(report.c_str(), out);
+  if (out != stdout) std::fclose(out);
+  return 0;
+}
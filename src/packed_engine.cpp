@@ -0,0 +1,128 @@
+#include "packed_engine.h"
+
+#include <algorithm>
+#include <utility>
+
+PackedEngine::PackedEngine(Board initial, const PackedEngineOptions& options)
+    : current_(initial), next_(current_.Width(), current_.Height()), options_(options) {
+  // More stripes than rows would leave workers idle
+  const int threads = std::clamp(options_.threads, 1, std::max(current_.Height(), 1));
+  if (threads > 1) pool_ = std::make_unique<ThreadPool>(threads);
+  if (options_.schedule == Schedule::kTiles) {
+    const int tileSize = std::max(options_.tileSize, 1);
+    tileWords_ = std::max(tileSize / Board::kBitsPerWord, 1);
+    tileRows_ = tileSize;
+    tilesX_ = (current_.WordsPerRow() + tileWords_ - 1) / tileWords_;
+    tilesY_ = (current_.Height() + tileRows_ - 1) / tileRows_;
+    scheduler_ = std::make_unique<TileScheduler>(threads);
+    // The back buffer starts out blank, so every tile has to be stepped the first time
+    changed_.assign(TileCount(), 1);
+    nextChanged_.assign(TileCount(), 0);
+    pendingChanged_.assign(TileCount(), 0);
+  }
+}
+
+bool PackedEngine::TakeChangedRegions(std::vector<CellRect>* regions) {
+  if (!scheduler_) return false;
+  // One rectangle per horizontal run of changed tiles
+  const int tileCells = tileWords_ * Board::kBitsPerWord;
+  for (int tileY = 0; tileY < tilesY_; ++tileY) {
+    const uint8_t* row = &pendingChanged_[static_cast<size_t>(tileY) * tilesX_];
+    for (int tileX = 0; tileX < tilesX_;) {
+      if (!row[tileX]) {
+        ++tileX;
+        continue;
+      }
+      const int runBegin = tileX;
+      while (tileX < tilesX_ && row[tileX]) ++tileX;
+      const int x = runBegin * tileCells;
+      const int y = tileY * tileRows_;
+      regions->push_back(CellRect{x, y, std::min(tileX * tileCells, current_.Width()) - x,
+                                  std::min(y + tileRows_, current_.Height()) - y});
+    }
+  }
+  std::fill(pendingChanged_.begin(), pendingChanged_.end(), 0);
+  return true;
+}
+
+std::vector<WorkerStats> PackedEngine::SchedulerStats() const {
+  return scheduler_ ? scheduler_->Stats() : std::vector<WorkerStats>{};
+}
+
+const Board& PackedEngine::View() {
+  if (viewGeneration_ != generation_) {
+    current_.CopyTo(&view_);
+    viewGeneration_ = generation_;
+  }
+  return view_;
+}
+
+void PackedEngine::Step() {
+  current_.RefreshGhosts();
+  if (scheduler_) {
+    CollectActiveTiles();
+    std::fill(nextChanged_.begin(), nextChanged_.end(), 0);
+    scheduler_->Run(pool_.get(), ActiveTileCount(), [this](int index) { StepTile(activeTiles_[index]); });
+    std::swap(changed_, nextChanged_);
+    // Only active tiles can have changed
+    for (const int tile : activeTiles_) pendingChanged_[tile] |= changed_[tile];
+  } else if (pool_) {
+    const int stripeCount = pool_->ThreadCount();
+    pool_->Run([this, stripeCount](int worker) { StepStripe(worker, stripeCount); });
+  } else {
+    StepPaddedRows(options_.kernel, options_.rule, current_, &next_, 0, current_.Height(), 0, current_.WordsPerRow());
+  }
+  std::swap(current_, next_);
+  ++generation_;
+}
+
+void PackedEngine::Step(uint64_t generations) {
+  for (uint64_t i = 0; i < generations; ++i) Step();
+}
+
+void PackedEngine::StepStripe(int stripe, int stripeCount) {
+  // Stripes only write their own rows of next_ and read current_, whose boundary rows double as the halo. The ghost
+  // rows stand in for the opposite edge above the first board row and below the last.
+  const int height = current_.Height();
+  const int yBegin = static_cast<int>(static_cast<int64_t>(height) * stripe / stripeCount);
+  const int yEnd = static_cast<int>(static_cast<int64_t>(height) * (stripe + 1) / stripeCount);
+  StepPaddedRows(options_.kernel, options_.rule, current_, &next_, yBegin, yEnd, 0, current_.WordsPerRow());
+}
+
+void PackedEngine::StepTile(int tile) {
+  const int yBegin = (tile / tilesX_) * tileRows_;
+  const int yEnd = std::min(yBegin + tileRows_, current_.Height());
+  const int wordBegin = (tile % tilesX_) * tileWords_;
+  const int wordEnd = std::min(wordBegin + tileWords_, current_.WordsPerRow());
+  StepPaddedRows(options_.kernel, options_.rule, current_, &next_, yBegin, yEnd, wordBegin, wordEnd);
+
+  // Padding bits of current_ hold ghost cells, so the last word only compares its cells
+  const bool lastWord = wordEnd == current_.WordsPerRow();
+  const int compareEnd = lastWord ? wordEnd - 1 : wordEnd;
+  uint64_t difference = 0;
+  for (int y = yBegin; y < yEnd; ++y) {
+    const uint64_t* before = current_.Row(y);
+    const uint64_t* after = next_.Row(y);
+    for (int i = wordBegin; i < compareEnd; ++i) difference |= before[i] ^ after[i];
+    if (lastWord) difference |= (before[compareEnd] ^ after[compareEnd]) & current_.TailMask();
+  }
+  nextChanged_[tile] = difference != 0;
+}
+
+void PackedEngine::CollectActiveTiles() {
+  activeTiles_.clear();
+  for (int tileY = 0; tileY < tilesY_; ++tileY) {
+    for (int tileX = 0; tileX < tilesX_; ++tileX) {
+      bool active = !options_.skipStableTiles;
+      // The board is a torus, so the neighborhood wraps around the tile grid too
+      for (int dy = -1; dy <= 1 && !active; ++dy) {
+        const int y = (tileY + dy + tilesY_) % tilesY_;
+        for (int dx = -1; dx <= 1 && !active; ++dx) {
+          const int x = (tileX + dx + tilesX_) % tilesX_;
+          active = changed_[y * tilesX_ + x] != 0;
+        }
+      }
+      if (active) activeTiles_.push_back(tileY * tilesX_ + tileX);
+    }
+  }
+}
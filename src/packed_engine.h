@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board.h"
+#include "engine.h"
+#include "padded_board.h"
+#include "step.h"
+#include "thread_pool.h"
+#include "tile_scheduler.h"
+
+// How a generation is split across worker threads
+enum class Schedule {
+  kStripes,  // one horizontal stripe per worker
+  kTiles,    // square tiles handed out through work-stealing deques
+};
+
+struct PackedEngineOptions {
+  // Must be a kernel made for `rule` (see StepKernel::ForRule); the default handles any rule
+  RowKernel kernel = StepRowScalar;
+  Rule rule = kConwayRule;
+  // Worker threads stepping the board; 1 steps everything on the calling thread
+  int threads = 1;
+  Schedule schedule = Schedule::kTiles;
+  // Tile edge in cells; the width is rounded down to whole 64-cell words
+  int tileSize = 256;
+  // With the tile schedule, only step tiles that changed last generation or border one that did
+  bool skipStableTiles = true;
+};
+
+// Steps a packed board one generation at a time with the word-parallel kernels, double buffering between two boards.
+// Each generation is split into stripes or tiles (see Schedule) that are stepped in parallel. Both boards carry ghost
+// cells (see PaddedBoard), refreshed once per generation, so the torus wrap costs nothing inside the step.
+//
+// With the tile schedule the engine also remembers which tiles changed in the last generation. A tile whose 3x3 tile
+// neighborhood was entirely unchanged cannot change either, and because it was unchanged the back buffer already holds
+// its current contents, so it is skipped without even a copy. Step cost then follows activity rather than board area.
+class PackedEngine : public Engine {
+ public:
+  PackedEngine(Board initial, const PackedEngineOptions& options);
+
+  const char* Name() const override { return "packed"; }
+  void Advance(uint64_t generations) override { Step(generations); }
+  uint64_t Generation() const override { return generation_; }
+  uint64_t Population() const override { return current_.Population(); }
+  // Copied out of the padded board at most once per generation
+  const Board& View() override;
+  // Tracked per tile with the tile schedule; the stripe schedule does not track changes
+  bool TakeChangedRegions(std::vector<CellRect>* regions) override;
+
+  void Step();
+  void Step(uint64_t generations);
+
+  const PaddedBoard& Current() const { return current_; }
+  int ThreadCount() const { return pool_ ? pool_->ThreadCount() : 1; }
+  int TileCount() const { return tilesX_ * tilesY_; }
+  // Tiles stepped in the last generation (all of them unless skipStableTiles is on)
+  int ActiveTileCount() const { return static_cast<int>(activeTiles_.size()); }
+
+  // Tile and steal counts per worker; empty with the stripe schedule
+  std::vector<WorkerStats> SchedulerStats() const;
+
+ private:
+  void StepStripe(int stripe, int stripeCount);
+  void StepTile(int tile);
+  void CollectActiveTiles();
+
+  PaddedBoard current_;
+  PaddedBoard next_;
+  Board view_;
+  uint64_t viewGeneration_ = ~uint64_t{0};
+  PackedEngineOptions options_;
+  std::unique_ptr<ThreadPool> pool_;
+  std::unique_ptr<TileScheduler> scheduler_;
+  int tileWords_ = 1;
+  int tileRows_ = 1;
+  int tilesX_ = 0;
+  int tilesY_ = 0;
+  // Per tile: whether it changed in the last generation / is changing in the one being stepped
+  std::vector<uint8_t> changed_;
+  std::vector<uint8_t> nextChanged_;
+  // Per tile: whether it changed since the last TakeChangedRegions()
+  std::vector<uint8_t> pendingChanged_;
+  std::vector<int> activeTiles_;
+  uint64_t generation_ = 0;
+};
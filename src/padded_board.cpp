@@ -0,0 +1,61 @@
+#include "padded_board.h"
+
+#include <algorithm>
+#include <bit>
+
+PaddedBoard::PaddedBoard(int width, int height)
+    : width_(width),
+      height_(height),
+      wordsPerRow_((width + Board::kBitsPerWord - 1) / Board::kBitsPerWord),
+      stride_(wordsPerRow_ + 2),
+      tailMask_(width % Board::kBitsPerWord == 0 ? ~uint64_t{0}
+                                                 : (uint64_t{1} << (width % Board::kBitsPerWord)) - 1),
+      words_(static_cast<size_t>(stride_) * (height + 2), 0) {}
+
+PaddedBoard::PaddedBoard(const Board& board) : PaddedBoard(board.Width(), board.Height()) {
+  for (int y = 0; y < height_; ++y) std::copy(board.Row(y), board.Row(y) + wordsPerRow_, Row(y));
+}
+
+void PaddedBoard::RefreshGhosts() {
+  if (wordsPerRow_ == 0 || height_ == 0) return;
+  // Cells in use in the last word; the ones after them stand for cells 0, 1, ... of the same row
+  const int tail = std::countr_one(tailMask_);
+  const int last = wordsPerRow_ - 1;
+  for (int y = 0; y < height_; ++y) {
+    uint64_t* row = Row(y);
+    const uint64_t lastWord = row[last] & tailMask_;
+    const uint64_t firstWord = last == 0 ? lastWord : row[0];
+    // Bit 63 of the left ghost is the row's last cell, the left neighbor of cell 0
+    row[-1] = (lastWord >> (tail - 1)) << (Board::kBitsPerWord - 1);
+    if (tail < Board::kBitsPerWord) {
+      // Bit `tail` of the last word is cell 0, the right neighbor of the last cell; the right ghost only feeds
+      // padding bits
+      row[last] = lastWord | (firstWord << tail);
+      row[wordsPerRow_] = 0;
+    } else {
+      row[wordsPerRow_] = firstWord;
+    }
+  }
+  // Ghost rows last, so their corners carry the wrapped cells too
+  std::copy(Row(height_ - 1) - 1, Row(height_ - 1) - 1 + stride_, Row(-1) - 1);
+  std::copy(Row(0) - 1, Row(0) - 1 + stride_, Row(height_) - 1);
+}
+
+void PaddedBoard::CopyTo(Board* board) const {
+  if (board->Width() != width_ || board->Height() != height_) *board = Board(width_, height_);
+  for (int y = 0; y < height_; ++y) {
+    uint64_t* out = board->Row(y);
+    std::copy(Row(y), Row(y) + wordsPerRow_, out);
+    if (wordsPerRow_ > 0) out[wordsPerRow_ - 1] &= tailMask_;
+  }
+}
+
+size_t PaddedBoard::Population() const {
+  size_t population = 0;
+  for (int y = 0; y < height_; ++y) {
+    const uint64_t* row = Row(y);
+    for (int i = 0; i + 1 < wordsPerRow_; ++i) population += std::popcount(row[i]);
+    if (wordsPerRow_ > 0) population += std::popcount(row[wordsPerRow_ - 1] & tailMask_);
+  }
+  return population;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+// Packed board with ghost cells around it for the torus wrap. Each row has one extra word on either side and the board
+// has one extra row above and below. RefreshGhosts() fills them from the opposite edges, and also fills the padding
+// bits of each row's last word with the wrapped-around cells. Afterwards every word can be stepped by the interior row
+// kernels, with no edge words, no wrapped row indices and no divisions.
+//
+// Between RefreshGhosts() and the next step the padding bits hold ghost cells, so anything reading cells masks the last
+// word with TailMask().
+class PaddedBoard {
+ public:
+  PaddedBoard() = default;
+  PaddedBoard(int width, int height);
+  explicit PaddedBoard(const Board& board);
+
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+  int WordsPerRow() const { return wordsPerRow_; }
+  uint64_t TailMask() const { return tailMask_; }
+
+  // Word 0 of row y, for y in [-1, Height()]. Words -1 and WordsPerRow() are the ghost words.
+  uint64_t* Row(int y) { return words_.data() + static_cast<size_t>(y + 1) * stride_ + 1; }
+  const uint64_t* Row(int y) const { return words_.data() + static_cast<size_t>(y + 1) * stride_ + 1; }
+
+  void RefreshGhosts();
+  void CopyTo(Board* board) const;
+  size_t Population() const;
+
+ private:
+  int width_ = 0;
+  int height_ = 0;
+  int wordsPerRow_ = 0;
+  int stride_ = 0;
+  uint64_t tailMask_ = 0;
+  std::vector<uint64_t> words_;
+};
@@ -0,0 +1,65 @@
+#include "png_file.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "thread_pool.h"
+
+#if LIFE_HAVE_STB
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include "stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#endif
+
+bool LoadPngBoard(const std::string& path, Board* board, std::string* error) {
+#if LIFE_HAVE_STB
+  int width, height, channels;
+  if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+    *error = path + ": " + stbi_failure_reason();
+    return false;
+  }
+  // Decode straight to the one channel that decides each cell, alpha when there is one and luma otherwise, rather
+  // than expanding every pixel to RGBA
+  const bool alpha = channels == 2 || channels == 4;
+  stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, alpha ? 2 : 1);
+  if (pixels == nullptr) {
+    *error = path + ": " + stbi_failure_reason();
+    return false;
+  }
+  *board = alpha ? BoardFromChannel(pixels, width, height, 2, 1, 1)
+                 : BoardFromChannel(pixels, width, height, 1, 0, kLumaThreshold);
+  stbi_image_free(pixels);
+  return true;
+#else
+  (void)board;
+  *error = path + ": PNG support was not built in";
+  return false;
+#endif
+}
+
+bool SavePngBoard(const std::string& path, const Board& board, std::string* error) {
+#if LIFE_HAVE_STB
+  // raylib's PURPLE for live cells, transparent for dead ones
+  const Rgba alive{200, 122, 255, 255};
+  const Rgba dead{0, 0, 0, 0};
+  const size_t rowBytes = static_cast<size_t>(board.Width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * board.Height());
+  // Large boards are expanded by every hardware thread, one band of rows each
+  const bool large = static_cast<int64_t>(board.Width()) * board.Height() >= (int64_t{1} << 22);
+  ThreadPool pool(large ? ThreadPool::DefaultThreadCount() : 1);
+  pool.RunRanges(board.Height(), [&](int begin, int end) {
+    BoardToRgba(board, 0, begin, board.Width(), end - begin, alive, dead, pixels.data() + begin * rowBytes);
+  });
+  if (!stbi_write_png(path.c_str(), board.Width(), board.Height(), 4, pixels.data(), board.Width() * 4)) {
+    *error = path + ": could not write PNG";
+    return false;
+  }
+  return true;
+#else
+  (void)board;
+  *error = path + ": PNG support was not built in";
+  return false;
+#endif
+}
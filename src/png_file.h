@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+#include "board.h"
+
+// PNG pattern files for the headless runner, which cannot use raylib's image loading. Cells are read the way
+// BoardFromImage reads them (not fully transparent, or bright in opaque images), and saved boards use the same colors
+// as the window so they can be loaded back by either executable.
+
+bool LoadPngBoard(const std::string& path, Board* board, std::string* error);
+bool SavePngBoard(const std::string& path, const Board& board, std::string* error);
@@ -0,0 +1,271 @@
+#include "rle_file.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+constexpr size_t kMaxLineLength = 70;
+// Largest run or board edge accepted, so a corrupt file cannot ask for an absurd allocation
+constexpr int kMaxRleSize = 1 << 24;
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+  while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+  return text;
+}
+
+bool ParseSize(std::string_view text, int* value) {
+  const char* end = text.data() + text.size();
+  const auto [parsedEnd, errorCode] = std::from_chars(text.data(), end, *value);
+  return !text.empty() && errorCode == std::errc{} && parsedEnd == end && *value >= 0 && *value <= kMaxRleSize;
+}
+
+// Sets cells [x, x + count) of row y, a word at a time
+void SetRun(Board* board, int x, int y, int count) {
+  uint64_t* row = board->Row(y);
+  const int end = x + count;
+  while (x < end) {
+    const int bit = x % Board::kBitsPerWord;
+    const int bits = std::min(Board::kBitsPerWord - bit, end - x);
+    const uint64_t mask = bits == Board::kBitsPerWord ? ~uint64_t{0} : ((uint64_t{1} << bits) - 1) << bit;
+    row[x / Board::kBitsPerWord] |= mask;
+    x += bits;
+  }
+}
+
+// First cell at or after x in row y whose state differs from `alive`, or the board width
+int NextTransition(const Board& board, int x, int y, bool alive) {
+  if (x >= board.Width()) return board.Width();
+  const uint64_t* row = board.Row(y);
+  const uint64_t flip = alive ? ~uint64_t{0} : 0;
+  int word = x / Board::kBitsPerWord;
+  uint64_t bits = (row[word] ^ flip) & (~uint64_t{0} << (x % Board::kBitsPerWord));
+  while (bits == 0 && ++word < board.WordsPerRow()) bits = row[word] ^ flip;
+  if (bits == 0) return board.Width();
+  return std::min(word * Board::kBitsPerWord + std::countr_zero(bits), board.Width());
+}
+
+// Appends "<count><tag>" and wraps the line before it would grow past kMaxLineLength
+void AppendRun(std::string* out, size_t* lineStart, int count, std::string_view tag) {
+  char item[16];
+  char* end = count > 1 ? std::to_chars(item, item + sizeof(item) - tag.size(), count).ptr : item;
+  end = std::copy(tag.begin(), tag.end(), end);
+  const size_t length = static_cast<size_t>(end - item);
+  if (out->size() - *lineStart + length > kMaxLineLength) {
+    *out += '\n';
+    *lineStart = out->size();
+  }
+  out->append(item, length);
+}
+
+// Multi-state token: '.' for dead, 'A'..'X' for states 1..24, and a prefix p..y for each further 24 states
+std::string StateToken(int state) {
+  if (state == 0) return ".";
+  std::string token;
+  if (state > 24) token += static_cast<char>('p' + (state - 25) / 24);
+  token += static_cast<char>('A' + (state - 1) % 24);
+  return token;
+}
+
+// 0 for dead, 1 for alive, age + 1 for dying cells
+int CellState(const Board& board, const std::vector<Board>& ages, int x, int y) {
+  if (board.Get(x, y)) return 1;
+  int age = 0;
+  for (size_t k = 0; k < ages.size(); ++k) age |= static_cast<int>(ages[k].Get(x, y)) << k;
+  return age == 0 ? 0 : age + 1;
+}
+
+// Header line "x = 3, y = 3, rule = B3/S23"; unknown keys are ignored
+bool ParseHeader(std::string_view line, int* width, int* height, std::string* rule, std::string* error) {
+  bool seenWidth = false;
+  bool seenHeight = false;
+  while (!line.empty()) {
+    const size_t equals = line.find('=');
+    if (equals == std::string_view::npos) {
+      *error = "malformed RLE header";
+      return false;
+    }
+    const std::string_view key = Trim(line.substr(0, equals));
+    // The rule may itself contain commas (Larger than Life rules, Golly grid sizes), so it takes the rest of the line
+    const size_t comma = key == "rule" ? std::string_view::npos : line.find(',', equals);
+    const std::string_view value =
+        Trim(line.substr(equals + 1, comma == std::string_view::npos ? comma : comma - equals - 1));
+    line = comma == std::string_view::npos ? std::string_view() : line.substr(comma + 1);
+    if (key == "x") {
+      seenWidth = ParseSize(value, width);
+    } else if (key == "y") {
+      seenHeight = ParseSize(value, height);
+    } else if (key == "rule") {
+      // Golly appends the grid topology as ":T100,100"; the engines pick their own
+      *rule = value.substr(0, value.find(':'));
+    }
+  }
+  if (!seenWidth || !seenHeight) {
+    *error = "RLE header needs valid x and y sizes";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ParseRle(std::string_view text, Board* board, std::vector<Board>* ages, std::string* rule, std::string* error) {
+  rule->clear();
+  // Comment lines start with '#' and come before the header
+  std::string_view line;
+  while (true) {
+    if (text.empty()) {
+      *error = "missing RLE header";
+      return false;
+    }
+    const size_t newline = text.find('\n');
+    line = Trim(text.substr(0, newline));
+    text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+    if (!line.empty() && line.front() != '#') break;
+  }
+  int width = 0;
+  int height = 0;
+  if (!ParseHeader(line, &width, &height, rule, error)) return false;
+
+  Board decoded(width, height);
+  std::vector<Board> decodedAges;
+  int x = 0;
+  int y = 0;
+  int count = 0;
+  bool counting = false;
+  for (size_t i = 0; i < text.size(); ++i) {
+    const char c = text[i];
+    if (c >= '0' && c <= '9') {
+      count = count * 10 + (c - '0');
+      counting = true;
+      if (count > kMaxRleSize) {
+        *error = "RLE run too long";
+        return false;
+      }
+      continue;
+    }
+    if (IsSpace(c)) continue;
+    if (c == '!') break;
+    const int run = counting ? count : 1;
+    count = 0;
+    counting = false;
+    if (c == '$') {
+      // Stops at the bottom edge, so any number of skips cannot overflow; cells after that are caught below
+      y = std::min(y + run, height);
+      x = 0;
+      continue;
+    }
+    int state;
+    if (c == 'b' || c == '.') {
+      state = 0;
+    } else if (c == 'o') {
+      state = 1;
+    } else if (c >= 'A' && c <= 'X') {
+      state = c - 'A' + 1;
+    } else if (c >= 'p' && c <= 'y' && i + 1 < text.size() && text[i + 1] >= 'A' && text[i + 1] <= 'X') {
+      // Multi-state patterns write states above 24 as a prefix letter p..y followed by A..X
+      state = 24 * (c - 'p' + 1) + text[++i] - 'A' + 1;
+    } else {
+      *error = std::string("unexpected '") + c + "' in RLE data";
+      return false;
+    }
+    if (run > 0 && (y >= height || x + run > width)) {
+      *error = "RLE pattern extends past its x/y size";
+      return false;
+    }
+    if (state == 1 && run > 0) SetRun(&decoded, x, y, run);
+    if (state > 1 && run > 0) {
+      const int age = state - 1;
+      for (int k = 0; (age >> k) != 0; ++k) {
+        if (k == static_cast<int>(decodedAges.size())) decodedAges.emplace_back(width, height);
+        if ((age >> k) & 1) SetRun(&decodedAges[k], x, y, run);
+      }
+    }
+    x += run;
+  }
+  *board = std::move(decoded);
+  *ages = std::move(decodedAges);
+  return true;
+}
+
+bool LoadRleBoard(const std::string& path, Board* board, std::vector<Board>* ages, std::string* rule,
+                  std::string* error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    *error = path + ": could not open";
+    return false;
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  if (!ParseRle(contents.str(), board, ages, rule, error)) {
+    *error = path + ": " + *error;
+    return false;
+  }
+  return true;
+}
+
+std::string RleFromBoard(const Board& board, const std::vector<Board>& ages, std::string_view rule) {
+  std::string out = "x = " + std::to_string(board.Width()) + ", y = " + std::to_string(board.Height());
+  if (!rule.empty()) out += ", rule = " + std::string(rule);
+  out += '\n';
+  size_t lineStart = out.size();
+  const bool multiState = !ages.empty();
+  // Blank rows and trailing dead cells are folded into the row separators
+  int currentRow = 0;
+  for (int y = 0; y < board.Height(); ++y) {
+    int x = NextTransition(board, 0, y, false);
+    if (multiState) {
+      for (const Board& plane : ages) x = std::min(x, NextTransition(plane, 0, y, false));
+    }
+    if (x == board.Width()) continue;
+    if (y > currentRow) AppendRun(&out, &lineStart, y - currentRow, "$");
+    currentRow = y;
+    if (x > 0) AppendRun(&out, &lineStart, x, multiState ? "." : "b");
+    if (multiState) {
+      // Past the leading blank run, cells are compared one at a time across the planes
+      while (x < board.Width()) {
+        const int state = CellState(board, ages, x, y);
+        int end = x + 1;
+        while (end < board.Width() && CellState(board, ages, end, y) == state) ++end;
+        if (state != 0 || end < board.Width()) AppendRun(&out, &lineStart, end - x, StateToken(state));
+        x = end;
+      }
+      continue;
+    }
+    while (x < board.Width()) {
+      const int aliveEnd = NextTransition(board, x, y, true);
+      AppendRun(&out, &lineStart, aliveEnd - x, "o");
+      x = NextTransition(board, aliveEnd, y, false);
+      if (x < board.Width()) AppendRun(&out, &lineStart, x - aliveEnd, "b");
+    }
+  }
+  AppendRun(&out, &lineStart, 1, "!");
+  out += '\n';
+  return out;
+}
+
+bool SaveRleBoard(const std::string& path, const Board& board, const std::vector<Board>& ages, std::string_view rule,
+                  std::string* error) {
+  std::ofstream file(path, std::ios::binary);
+  const std::string contents = RleFromBoard(board, ages, rule);
+  if (!file || !file.write(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+    *error = path + ": could not write RLE";
+    return false;
+  }
+  return true;
+}
+
+bool IsRlePath(std::string_view path) {
+  if (path.size() < 4) return false;
+  std::string extension(path.substr(path.size() - 4));
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; });
+  return extension == ".rle";
+}
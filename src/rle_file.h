@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "board.h"
+
+// Run-length encoded pattern files, the format Golly and LifeWiki use. The header "x = <width>, y = <height>, rule =
+// <rule>" sizes the board, and the body is decoded straight into its words, so large patterns load without ever
+// existing as pixels. Multi-state patterns ('.', 'A', 'B', ...) keep state 1 on the board and the higher states of
+// Generations rules as decay ages, laid out like Engine::ViewAges: state s is age s - 1, one plane per bit.
+
+// `rule` receives the header's rule string without any Golly grid suffix, or is cleared when there is none. `ages` is
+// cleared unless the pattern has cells above state 1.
+bool ParseRle(std::string_view text, Board* board, std::vector<Board>* ages, std::string* rule, std::string* error);
+bool LoadRleBoard(const std::string& path, Board* board, std::vector<Board>* ages, std::string* rule,
+                  std::string* error);
+
+// Encodes the whole board with lines of at most 70 characters, as the format recommends. `rule` may be empty. Any age
+// planes, which must be sized like the board, switch it to multi-state tokens; without them the body uses 'b' and 'o'.
+std::string RleFromBoard(const Board& board, const std::vector<Board>& ages, std::string_view rule);
+bool SaveRleBoard(const std::string& path, const Board& board, const std::vector<Board>& ages, std::string_view rule,
+                  std::string* error);
+
+// Whether `path` names an RLE file, judging by its extension
+bool IsRlePath(std::string_view path);
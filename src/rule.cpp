@@ -0,0 +1,116 @@
+#include "rule.h"
+
+#include <utility>
+
+namespace {
+
+// Reads neighbor-count digits up to the next '/' (or any letter) into a 9-bit table
+bool ParseCounts(std::string_view* text, uint16_t* counts) {
+  *counts = 0;
+  while (!text->empty() && (*text)[0] >= '0' && (*text)[0] <= '9') {
+    if ((*text)[0] == '9') return false;
+    *counts |= 1 << ((*text)[0] - '0');
+    text->remove_prefix(1);
+  }
+  return true;
+}
+
+// Reads a Generations state count, 2..kMaxStates
+bool ParseStates(std::string_view* text, uint16_t* states) {
+  int value = 0;
+  size_t digits = 0;
+  while (digits < text->size() && (*text)[digits] >= '0' && (*text)[digits] <= '9' && value <= kMaxStates) {
+    value = value * 10 + ((*text)[digits] - '0');
+    ++digits;
+  }
+  if (digits == 0 || value < 2 || value > kMaxStates) return false;
+  *states = static_cast<uint16_t>(value);
+  text->remove_prefix(digits);
+  return true;
+}
+
+char Lower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+}  // namespace
+
+RuleFamily ClassifyRule(const Rule& rule) {
+  const Rule lifeLike{rule.birth, rule.survival};
+  if (lifeLike == kConwayRule) return RuleFamily::kConway;
+  if (lifeLike == kHighLifeRule) return RuleFamily::kHighLife;
+  if (lifeLike == kSeedsRule) return RuleFamily::kSeeds;
+  if (lifeLike == kDayAndNightRule) return RuleFamily::kDayAndNight;
+  return RuleFamily::kGeneric;
+}
+
+bool ParseRule(std::string_view text, Rule* rule, std::string* error) {
+  constexpr std::pair<std::string_view, Rule> kNamedRules[] = {
+      {"life", kConwayRule},         {"highlife", kHighLifeRule},       {"seeds", kSeedsRule},
+      {"daynight", kDayAndNightRule}, {"briansbrain", kBriansBrainRule}, {"starwars", kStarWarsRule}};
+  for (const auto& [name, namedRule] : kNamedRules) {
+    if (text == name) {
+      *rule = namedRule;
+      return true;
+    }
+  }
+
+  const std::string invalid = "invalid rule '" + std::string(text) + "', expected B/S notation such as B3/S23";
+  Rule parsed{0, 0};
+  if (!text.empty() && ((text[0] >= '0' && text[0] <= '9') || text[0] == '/')) {
+    // Survival/birth[/states]: "23/3", "/2/3"
+    bool valid = ParseCounts(&text, &parsed.survival) && text.starts_with('/');
+    if (valid) {
+      text.remove_prefix(1);
+      valid = ParseCounts(&text, &parsed.birth);
+    }
+    if (valid && text.starts_with('/')) {
+      text.remove_prefix(1);
+      valid = ParseStates(&text, &parsed.states);
+    }
+    if (!valid || !text.empty()) {
+      *error = invalid;
+      return false;
+    }
+    *rule = parsed;
+    return true;
+  }
+
+  bool seenBirth = false;
+  bool seenSurvival = false;
+  bool seenStates = false;
+  while (!text.empty()) {
+    const char part = Lower(text[0]);
+    text.remove_prefix(1);
+    bool valid = false;
+    if (part == 'b' && !seenBirth) {
+      valid = seenBirth = ParseCounts(&text, &parsed.birth);
+    } else if (part == 's' && !seenSurvival) {
+      valid = seenSurvival = ParseCounts(&text, &parsed.survival);
+    } else if ((part == 'c' || part == 'g') && !seenStates) {
+      valid = seenStates = ParseStates(&text, &parsed.states);
+    }
+    if (!valid) {
+      *error = invalid;
+      return false;
+    }
+    if (!text.empty() && text[0] == '/') text.remove_prefix(1);
+  }
+  if (!seenBirth || !seenSurvival) {
+    *error = invalid;
+    return false;
+  }
+  *rule = parsed;
+  return true;
+}
+
+std::string RuleString(const Rule& rule) {
+  std::string text = "B";
+  for (int n = 0; n <= 8; ++n) {
+    if ((rule.birth >> n) & 1) text += static_cast<char>('0' + n);
+  }
+  text += "/S";
+  for (int n = 0; n <= 8; ++n) {
+    if ((rule.survival >> n) & 1) text += static_cast<char>('0' + n);
+  }
+  if (rule.states > 2) text += "/C" + std::to_string(rule.states);
+  return text;
+}
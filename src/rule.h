@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Life-like cellular automaton rule in B/S notation. Bit n of `birth` is set when a dead cell with n live neighbors
+// comes alive, bit n of `survival` when a live cell with n live neighbors stays alive. Both are 9-bit tables indexed
+// by the neighbor count 0..8.
+//
+// With more than two `states` it is a Generations rule: a live cell that does not survive moves to state 2 and then
+// one state further every generation until it is dead again after state states - 1. Only live cells count as
+// neighbors, and dying cells cannot be born again until they are dead.
+struct Rule {
+  uint16_t birth = 1 << 3;
+  uint16_t survival = (1 << 2) | (1 << 3);
+  uint16_t states = 2;
+
+  bool operator==(const Rule& other) const = default;
+};
+
+constexpr Rule kConwayRule{1 << 3, (1 << 2) | (1 << 3)};
+constexpr Rule kHighLifeRule{(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)};
+constexpr Rule kSeedsRule{1 << 2, 0};
+constexpr Rule kDayAndNightRule{(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8),
+                                (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)};
+constexpr Rule kBriansBrainRule{1 << 2, 0, 3};
+constexpr Rule kStarWarsRule{1 << 2, (1 << 3) | (1 << 4) | (1 << 5), 4};
+constexpr int kMaxStates = 256;
+
+// Rules with their own hand-simplified step kernels; every other rule runs through the generic kernel. Only the
+// birth and survival tables matter, so a Generations rule shares the kernel of its B/S part.
+enum class RuleFamily { kConway, kHighLife, kSeeds, kDayAndNight, kGeneric };
+constexpr int kRuleFamilyCount = 5;
+
+RuleFamily ClassifyRule(const Rule& rule);
+
+// Accepts "B3/S23" style strings (case-insensitive, either part may come first, the slash is optional), the older
+// survival/birth form "23/3", and the names life, highlife, seeds, daynight, briansbrain and starwars. Generations
+// rules add the state count as "B2/S/C3" or "/2/3".
+bool ParseRule(std::string_view text, Rule* rule, std::string* error);
+
+// Canonical "B3/S23" form, with "/C<states>" appended for Generations rules
+std::string RuleString(const Rule& rule);
@@ -0,0 +1,117 @@
+#include "simulation_thread.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "generation_clock.h"
+
+namespace {
+
+// How long the thread sleeps when the rate limit leaves nothing to step
+constexpr std::chrono::milliseconds kIdleSleep{1};
+
+// Copies the whole words under `rect` between boards of the same size
+void CopyRegion(const Board& source, const CellRect& rect, Board* target) {
+  const int wordBegin = std::max(rect.x, 0) / Board::kBitsPerWord;
+  const int wordEnd = (std::min(rect.x + rect.width, source.Width()) + Board::kBitsPerWord - 1) / Board::kBitsPerWord;
+  const int yEnd = std::min(rect.y + rect.height, source.Height());
+  if (wordBegin >= wordEnd) return;
+  for (int y = std::max(rect.y, 0); y < yEnd; ++y) {
+    std::copy(source.Row(y) + wordBegin, source.Row(y) + wordEnd, target->Row(y) + wordBegin);
+  }
+}
+
+}  // namespace
+
+SimulationThread::SimulationThread(Engine* engine, double generationsPerSecond, uint64_t quantum,
+                                   double publishIntervalSeconds, uint64_t generationLimit)
+    : engine_(engine),
+      frames_(SimulationFrame{engine->View(), engine->ViewAges(), DensityPyramid(engine->View()), engine->Generation(),
+                              0}),
+      rate_(generationsPerSecond),
+      limit_(generationLimit),
+      thread_(&SimulationThread::Loop, this, quantum, publishIntervalSeconds) {}
+
+SimulationThread::~SimulationThread() { Stop(); }
+
+void SimulationThread::Stop() {
+  stopping_.store(true, std::memory_order_relaxed);
+  if (thread_.joinable()) thread_.join();
+}
+
+const SimulationFrame& SimulationThread::Latest(bool* fresh) {
+  const bool updated = frames_.Update();
+  if (fresh != nullptr) *fresh = updated;
+  return frames_.Front();
+}
+
+void SimulationThread::Loop(uint64_t quantum, double publishIntervalSeconds) {
+  GenerationClock clock(Rate(), quantum);
+  auto last = std::chrono::steady_clock::now();
+  while (!stopping_.load(std::memory_order_relaxed)) {
+    const double rate = Rate();
+    if (rate != clock.Rate()) clock.SetRate(rate);
+
+    const auto now = std::chrono::steady_clock::now();
+    uint64_t generations = clock.Plan(std::chrono::duration<double>(now - last).count(), publishIntervalSeconds);
+    last = now;
+    const uint64_t limit = limit_.load(std::memory_order_relaxed);
+    generations = std::min(generations, limit - std::min(limit, engine_->Generation()));
+    if (generations == 0) {
+      std::this_thread::sleep_for(kIdleSleep);
+      continue;
+    }
+
+    engine_->Advance(generations);
+    clock.Record(generations, std::chrono::duration<double>(std::chrono::steady_clock::now() - now).count());
+
+    changedRegions_.clear();
+    MarkStale(engine_->TakeChangedRegions(&changedRegions_));
+    FillBack();
+    SimulationFrame& frame = frames_.Back();
+    frame.generation = engine_->Generation();
+    frame.generationsPerSecond = clock.MeasuredRate();
+    frames_.Publish();
+  }
+}
+
+void SimulationThread::MarkStale(bool tracked) {
+  const Board& view = engine_->View();
+  const uint64_t boardArea = static_cast<uint64_t>(view.Width()) * view.Height();
+  for (StaleRegions& stale : stale_) {
+    // A slot the consumer holds on to keeps collecting regions; past a board's worth, one full copy is cheaper
+    if (tracked && !stale.all) {
+      for (const CellRect& rect : changedRegions_) {
+        stale.regions.push_back(rect);
+        stale.area += static_cast<uint64_t>(rect.width) * rect.height;
+      }
+    }
+    if (!tracked || stale.area >= boardArea) {
+      stale.all = true;
+      stale.regions.clear();
+      stale.area = 0;
+    }
+  }
+}
+
+void SimulationThread::FillBack() {
+  SimulationFrame& frame = frames_.Back();
+  StaleRegions& stale = stale_[frames_.BackIndex()];
+  const Board& view = engine_->View();
+  const std::vector<Board>& ages = engine_->ViewAges();
+  if (stale.all || frame.board.Width() != view.Width() || frame.board.Height() != view.Height() ||
+      frame.ages.size() != ages.size()) {
+    frame.board = view;
+    frame.ages = ages;
+    frame.density.Build(frame.board);
+  } else {
+    for (const CellRect& rect : stale.regions) {
+      CopyRegion(view, rect, &frame.board);
+      for (size_t plane = 0; plane < ages.size(); ++plane) CopyRegion(ages[plane], rect, &frame.ages[plane]);
+    }
+    frame.density.Update(frame.board, stale.regions);
+  }
+  stale.all = false;
+  stale.regions.clear();
+  stale.area = 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "board.h"
+#include "density_pyramid.h"
+#include "engine.h"
+#include "triple_buffer.h"
+
+// A completed generation as handed to the renderer
+struct SimulationFrame {
+  Board board;
+  // Decay planes for Generations rules (see Engine::ViewAges)
+  std::vector<Board> ages;
+  // Block populations of `board`, for zoomed-out drawing and statistics
+  DensityPyramid density;
+  uint64_t generation = 0;
+  // Generations stepped per second of real time, as measured by the simulation's GenerationClock
+  double generationsPerSecond = 0;
+};
+
+// Runs an engine on its own thread at a fixed generation rate (see GenerationClock) and publishes each completed batch
+// through a TripleBuffer, so the render loop never waits for a step, however long it takes. Batches are sized to
+// roughly one publish interval, which keeps the displayed board moving at frame rate when the simulation can keep up.
+// Each frame also carries a DensityPyramid of its board.
+//
+// Frames are reused rather than rebuilt. When the engine reports its changed regions, the thread remembers for each of
+// the three frame slots which regions it has missed since it was last filled, and brings the back slot up to date by
+// copying just those words and recounting just those pyramid blocks. Engines that do not report regions are copied
+// whole.
+class SimulationThread {
+ public:
+  // The engine must outlive this object and must not be touched by anyone else until Stop() returns. Stepping stops
+  // for good once the engine reaches `generationLimit`, which holds from the thread's first batch.
+  SimulationThread(Engine* engine, double generationsPerSecond, uint64_t quantum, double publishIntervalSeconds,
+                   uint64_t generationLimit = UINT64_MAX);
+  ~SimulationThread();
+
+  SimulationThread(const SimulationThread&) = delete;
+  SimulationThread& operator=(const SimulationThread&) = delete;
+
+  // Takes effect at the start of the next batch. 0 runs as fast as possible.
+  void SetRate(double generationsPerSecond) { rate_.store(generationsPerSecond, std::memory_order_relaxed); }
+  double Rate() const { return rate_.load(std::memory_order_relaxed); }
+
+  // Moves the generation limit for the batches still to come
+  void SetGenerationLimit(uint64_t generation) { limit_.store(generation, std::memory_order_relaxed); }
+
+  // Newest published frame. Never blocks; `fresh` (optional) reports whether it changed since the previous call.
+  const SimulationFrame& Latest(bool* fresh = nullptr);
+
+  // Finishes the batch in progress and joins the thread. Called by the destructor if needed.
+  void Stop();
+
+ private:
+  // Regions where a frame slot differs from the engine's view
+  struct StaleRegions {
+    // The whole board, when the engine did not report what changed or the regions add up to its area
+    bool all = false;
+    std::vector<CellRect> regions;
+    uint64_t area = 0;
+  };
+
+  void Loop(uint64_t quantum, double publishIntervalSeconds);
+  void MarkStale(bool tracked);
+  void FillBack();
+
+  Engine* engine_;
+  TripleBuffer<SimulationFrame> frames_;
+  // Owned by the simulation thread once it starts
+  std::vector<CellRect> changedRegions_;
+  std::array<StaleRegions, 3> stale_;
+  std::atomic<double> rate_;
+  std::atomic<uint64_t> limit_;
+  std::atomic<bool> stopping_{false};
+  std::thread thread_;
+};
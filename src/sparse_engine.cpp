@@ -0,0 +1,194 @@
+#include "sparse_engine.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+constexpr uint64_t kLeftColumn = 1;
+constexpr uint64_t kRightColumn = uint64_t{1} << 63;
+
+}  // namespace
+
+SparseEngine::SparseEngine(const Board& initial, const SparseEngineOptions& options)
+    : options_(options), view_(initial.Width(), initial.Height()) {
+  for (int y = 0; y < initial.Height(); ++y) {
+    const uint64_t* row = initial.Row(y);
+    for (int i = 0; i < initial.WordsPerRow(); ++i) {
+      if (row[i] != 0) chunks_[Key(i, y / kChunkSize)][y % kChunkSize] = row[i];
+    }
+  }
+}
+
+uint64_t SparseEngine::Population() const {
+  uint64_t population = 0;
+  for (const auto& [key, chunk] : chunks_) {
+    for (const uint64_t row : chunk) population += std::popcount(row);
+  }
+  return population;
+}
+
+void SparseEngine::Advance(uint64_t generations) {
+  for (uint64_t i = 0; i < generations; ++i) Step();
+}
+
+void SparseEngine::Step() {
+  // Every live chunk is stepped, plus the neighbors of any chunk with live cells on its border where births can spill
+  // over. Interior-only chunks cannot affect their neighbors.
+  candidates_.clear();
+  for (const auto& [key, chunk] : chunks_) {
+    candidates_.insert(key);
+    uint64_t columns = 0;
+    for (const uint64_t row : chunk) columns |= row;
+    const bool touchesBorder = chunk.front() != 0 || chunk.back() != 0 || (columns & (kLeftColumn | kRightColumn));
+    if (!touchesBorder) continue;
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) candidates_.insert(Key(ChunkX(key) + dx, ChunkY(key) + dy));
+    }
+  }
+
+  order_.assign(candidates_.begin(), candidates_.end());
+  std::sort(order_.begin(), order_.end(), [](uint64_t a, uint64_t b) {
+    return ChunkY(a) != ChunkY(b) ? ChunkY(a) < ChunkY(b) : ChunkX(a) < ChunkX(b);
+  });
+  nextChunks_.clear();
+  for (size_t begin = 0; begin < order_.size(); begin += kBatchChunks) {
+    StepBatch(order_.data() + begin, std::min(kBatchChunks, order_.size() - begin));
+  }
+  chunks_.swap(nextChunks_);
+  ++generation_;
+}
+
+const Board& SparseEngine::View() {
+  if (viewGeneration_ != generation_) {
+    view_.Clear();
+    const int chunksX = view_.WordsPerRow();
+    const int chunksY = (view_.Height() + kChunkSize - 1) / kChunkSize;
+    for (int chunkY = 0; chunkY < chunksY; ++chunkY) {
+      for (int chunkX = 0; chunkX < chunksX; ++chunkX) {
+        const Chunk* chunk = Find(chunkX, chunkY);
+        if (chunk == nullptr) continue;
+        const uint64_t mask = chunkX == chunksX - 1 ? view_.TailMask() : ~uint64_t{0};
+        const int rows = std::min(kChunkSize, view_.Height() - chunkY * kChunkSize);
+        for (int r = 0; r < rows; ++r) view_.Row(chunkY * kChunkSize + r)[chunkX] = (*chunk)[r] & mask;
+      }
+    }
+    viewGeneration_ = generation_;
+  }
+  return view_;
+}
+
+bool SparseEngine::ExportBoard(Board* board, std::string* error) {
+  if (chunks_.empty()) {
+    *board = Board(1, 1);
+    return true;
+  }
+  // Chunks are never empty, so each one has a first and last live row and column
+  int64_t minX = INT64_MAX;
+  int64_t minY = INT64_MAX;
+  int64_t maxX = INT64_MIN;
+  int64_t maxY = INT64_MIN;
+  for (const auto& [key, chunk] : chunks_) {
+    uint64_t columns = 0;
+    int firstRow = kChunkSize;
+    int lastRow = 0;
+    for (int r = 0; r < kChunkSize; ++r) {
+      if (chunk[r] == 0) continue;
+      columns |= chunk[r];
+      firstRow = std::min(firstRow, r);
+      lastRow = r;
+    }
+    const int64_t x = int64_t{ChunkX(key)} * kChunkSize;
+    const int64_t y = int64_t{ChunkY(key)} * kChunkSize;
+    minX = std::min(minX, x + std::countr_zero(columns));
+    maxX = std::max(maxX, x + 63 - std::countl_zero(columns));
+    minY = std::min(minY, y + firstRow);
+    maxY = std::max(maxY, y + lastRow);
+  }
+  const int64_t width = maxX - minX + 1;
+  const int64_t height = maxY - minY + 1;
+  // Board sizes are ints, so a long thin box fails too; checking each side first also keeps the product in range
+  if (width > INT_MAX || height > INT_MAX || width * height > kMaxExportCells) {
+    *error = "live cells span " + std::to_string(width) + "x" + std::to_string(height) + ", too large for a board";
+    return false;
+  }
+  *board = Board(static_cast<int>(width), static_cast<int>(height));
+  // Chunk words land on the board shifted by the box's offset within its word, so each one straddles up to two words
+  for (const auto& [key, chunk] : chunks_) {
+    const int64_t x = int64_t{ChunkX(key)} * kChunkSize - minX;
+    const int64_t y = int64_t{ChunkY(key)} * kChunkSize - minY;
+    for (int r = 0; r < kChunkSize; ++r) {
+      if (chunk[r] == 0) continue;
+      uint64_t* row = board->Row(static_cast<int>(y + r));
+      // x is a multiple of 64 minus the box's offset, so it is never below -63
+      const int64_t word = (x + kChunkSize) / kChunkSize - 1;
+      const int shift = static_cast<int>(x - word * kChunkSize);
+      if (word >= 0) row[word] |= chunk[r] << shift;
+      if (shift != 0 && word + 1 < board->WordsPerRow()) row[word + 1] |= chunk[r] >> (kChunkSize - shift);
+    }
+  }
+  return true;
+}
+
+const SparseEngine::Chunk* SparseEngine::Find(int32_t chunkX, int32_t chunkY) const {
+  const auto it = chunks_.find(Key(chunkX, chunkY));
+  return it == chunks_.end() ? nullptr : &it->second;
+}
+
+void SparseEngine::GatherColumn(int32_t chunkX, int32_t chunkY, int slot, uint64_t mask) {
+  const Chunk* above = Find(chunkX, chunkY - 1);
+  const Chunk* chunk = Find(chunkX, chunkY);
+  const Chunk* below = Find(chunkX, chunkY + 1);
+  uint64_t* column = batch_.data() + slot;
+  if (above != nullptr) column[0] |= above->back() & mask;
+  if (chunk != nullptr) {
+    for (int r = 0; r < kChunkSize; ++r) column[static_cast<size_t>(r + 1) * batchWords_] |= (*chunk)[r] & mask;
+  }
+  if (below != nullptr) column[static_cast<size_t>(kChunkSize + 1) * batchWords_] |= below->front() & mask;
+}
+
+void SparseEngine::StepBatch(const uint64_t* keys, size_t count) {
+  // Each batch row holds one row of every chunk, with a ghost word before each run of horizontally adjacent chunks and
+  // after the last one. The kernel only reads bit 63 of the word left of a chunk and bit 0 of the word right of it, so
+  // a single ghost word carries both the east neighbor of the run before it and the west neighbor of the run after.
+  slots_.clear();
+  int words = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const bool continuesRun =
+        i > 0 && ChunkY(keys[i]) == ChunkY(keys[i - 1]) && ChunkX(keys[i]) == ChunkX(keys[i - 1]) + 1;
+    if (!continuesRun) ++words;
+    slots_.push_back(words++);
+  }
+  batchWords_ = words + 1;
+
+  // Rows -1 through kChunkSize, the outer two being the halo from the chunks above and below
+  batch_.assign(static_cast<size_t>(kChunkSize + 2) * batchWords_, 0);
+  for (size_t i = 0; i < count; ++i) {
+    const int32_t chunkX = ChunkX(keys[i]);
+    const int32_t chunkY = ChunkY(keys[i]);
+    const int slot = slots_[i];
+    GatherColumn(chunkX, chunkY, slot, ~uint64_t{0});
+    if (i == 0 || slots_[i - 1] != slot - 1) GatherColumn(chunkX - 1, chunkY, slot - 1, kRightColumn);
+    if (i == count - 1 || slots_[i + 1] != slot + 1) GatherColumn(chunkX + 1, chunkY, slot + 1, kLeftColumn);
+  }
+
+  stepped_.resize(static_cast<size_t>(kChunkSize) * batchWords_);
+  for (int r = 0; r < kChunkSize; ++r) {
+    const uint64_t* above = batch_.data() + static_cast<size_t>(r) * batchWords_;
+    options_.kernel(above, above + batchWords_, above + 2 * batchWords_,
+                    stepped_.data() + static_cast<size_t>(r) * batchWords_, 1, batchWords_ - 1, options_.rule);
+  }
+
+  Chunk next;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t any = 0;
+    for (int r = 0; r < kChunkSize; ++r) {
+      next[r] = stepped_[static_cast<size_t>(r) * batchWords_ + slots_[i]];
+      any |= next[r];
+    }
+    if (any != 0) nextChunks_.emplace(keys[i], next);
+  }
+}
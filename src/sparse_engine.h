@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "board.h"
+#include "engine.h"
+#include "step.h"
+
+struct SparseEngineOptions {
+  // Must be a kernel made for `rule` (see StepKernel::ForRule); the default handles any rule
+  RowKernel kernel = StepRowScalar;
+  // Rules with B0 are not supported: they would fill the infinite empty plane
+  Rule rule = kConwayRule;
+};
+
+// Unbounded-plane Life on a hash map of 64x64 chunks. Chunks are created when activity reaches them and dropped as
+// soon as they are empty, so memory follows the live population instead of the pattern's bounding box, and escaping
+// gliders keep going rather than wrapping around like they do on the packed engine's torus.
+//
+// Each generation steps the candidate chunks in batches, sorted so that horizontal neighbors sit next to each other:
+// the batch's chunk rows are laid out side by side as one long row of words, and the step kernel runs across it in a
+// single call, so vector kernels work on several chunks at once.
+//
+// As with HashLife, the initial board is placed at the origin and View() shows that board-sized window.
+class SparseEngine : public Engine {
+ public:
+  static constexpr int kChunkSize = Board::kBitsPerWord;
+  // Chunks stepped per kernel call on each row, which keeps a batch's rows within the L2 cache
+  static constexpr size_t kBatchChunks = 256;
+
+  SparseEngine(const Board& initial, const SparseEngineOptions& options);
+
+  const char* Name() const override { return "sparse"; }
+  void Advance(uint64_t generations) override;
+  uint64_t Generation() const override { return generation_; }
+  uint64_t Population() const override;
+  const Board& View() override;
+  bool ExportBoard(Board* board, std::string* error) override;
+
+  void Step();
+
+  size_t ChunkCount() const { return chunks_.size(); }
+
+ private:
+  // One 64-bit word per row, bit x holding cell x of the chunk
+  using Chunk = std::array<uint64_t, kChunkSize>;
+
+  struct KeyHash {
+    size_t operator()(uint64_t key) const {
+      key = (key ^ (key >> 33)) * 0xff51afd7ed558ccdull;
+      return key ^ (key >> 33);
+    }
+  };
+
+  static uint64_t Key(int32_t chunkX, int32_t chunkY) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY);
+  }
+  static int32_t ChunkX(uint64_t key) { return static_cast<int32_t>(key >> 32); }
+  static int32_t ChunkY(uint64_t key) { return static_cast<int32_t>(key & 0xffffffff); }
+
+  const Chunk* Find(int32_t chunkX, int32_t chunkY) const;
+  // ORs column `chunkX` of chunk row `chunkY`, with a row of halo above and below, into word `slot` of every batch row
+  void GatherColumn(int32_t chunkX, int32_t chunkY, int slot, uint64_t mask);
+  void StepBatch(const uint64_t* keys, size_t count);
+
+  SparseEngineOptions options_;
+  std::unordered_map<uint64_t, Chunk, KeyHash> chunks_;
+  std::unordered_map<uint64_t, Chunk, KeyHash> nextChunks_;
+  std::unordered_set<uint64_t, KeyHash> candidates_;
+  // Candidates in (y, x) order, and the scratch rows of the batch being stepped
+  std::vector<uint64_t> order_;
+  std::vector<int> slots_;
+  int batchWords_ = 0;
+  std::vector<uint64_t> batch_;
+  std::vector<uint64_t> stepped_;
+  uint64_t generation_ = 0;
+
+  Board view_;
+  uint64_t viewGeneration_ = ~uint64_t{0};
+};
@@ -0,0 +1,164 @@
+#include "step.h"
+
+#include <algorithm>
+
+#include "step_logic.h"
+
+#if LIFE_X86 && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+
+template <class Logic>
+inline uint64_t StepWord(uint64_t aboveLeft, uint64_t above, uint64_t aboveRight, uint64_t left, uint64_t alive,
+                         uint64_t right, uint64_t belowLeft, uint64_t below, uint64_t belowRight, const Rule& rule) {
+  const NeighborCount<uint64_t> count =
+      CountNeighbors(aboveLeft, above, aboveRight, left, right, belowLeft, below, belowRight);
+  return Logic::Next(count, alive, rule);
+}
+
+template <class Logic>
+void StepRowWords(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, int begin, int end,
+                  const Rule& rule) {
+  for (int i = begin; i < end; ++i) {
+    out[i] = StepWord<Logic>((above[i] << 1) | (above[i - 1] >> 63), above[i], (above[i] >> 1) | (above[i + 1] << 63),
+                             (row[i] << 1) | (row[i - 1] >> 63), row[i], (row[i] >> 1) | (row[i + 1] << 63),
+                             (below[i] << 1) | (below[i - 1] >> 63), below[i], (below[i] >> 1) | (below[i + 1] << 63),
+                             rule);
+  }
+}
+
+// Left/right neighbor planes of word i of a row, wrapping around the board width. `lastBit` is the bit index of the
+// final cell in the last word.
+inline void WrappedNeighbors(const uint64_t* row, int i, int words, int lastBit, uint64_t* left, uint64_t* right) {
+  const uint64_t word = row[i];
+  const uint64_t leftCarry = i > 0 ? row[i - 1] >> 63 : (row[words - 1] >> lastBit) & 1;
+  *left = (word << 1) | leftCarry;
+  if (i < words - 1) {
+    *right = (word >> 1) | (row[i + 1] << 63);
+  } else {
+    // Padding bits are zero, so the bit just past the last cell is free to receive cell 0
+    *right = (word >> 1) | ((row[0] & 1) << lastBit);
+  }
+}
+
+// Edge words are a small share of any board, so only Conway's rule gets a specialized path here
+inline void StepEdgeWord(const Rule& rule, const Board& src, const uint64_t* above, const uint64_t* row,
+                         const uint64_t* below, uint64_t* out, int i) {
+  const int words = src.WordsPerRow();
+  const int lastBit = (src.Width() - 1) % Board::kBitsPerWord;
+  uint64_t aboveLeft, aboveRight, left, right, belowLeft, belowRight;
+  WrappedNeighbors(above, i, words, lastBit, &aboveLeft, &aboveRight);
+  WrappedNeighbors(row, i, words, lastBit, &left, &right);
+  WrappedNeighbors(below, i, words, lastBit, &belowLeft, &belowRight);
+  uint64_t next =
+      ClassifyRule(rule) == RuleFamily::kConway
+          ? StepWord<ConwayRule>(aboveLeft, above[i], aboveRight, left, row[i], right, belowLeft, below[i], belowRight,
+                                 rule)
+          : StepWord<GenericRule>(aboveLeft, above[i], aboveRight, left, row[i], right, belowLeft, below[i],
+                                  belowRight, rule);
+  if (i == words - 1) next &= src.TailMask();
+  out[i] = next;
+}
+
+#if LIFE_X86
+enum class CpuFeature { kSse2, kAvx2, kAvx512 };
+
+bool CpuSupports(CpuFeature feature) {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  const int maxLeaf = info[0];
+  __cpuid(info, 1);
+  const bool sse2 = (info[3] >> 26) & 1;
+  const bool osXsave = (info[2] >> 27) & 1;
+  if (feature == CpuFeature::kSse2) return sse2;
+  if (!osXsave || maxLeaf < 7) return false;
+  // The OS must save the YMM (and for AVX-512 the ZMM/opmask) state across context switches
+  const unsigned long long xcr0 = _xgetbv(0);
+  __cpuidex(info, 7, 0);
+  if (feature == CpuFeature::kAvx2) return (xcr0 & 0x6) == 0x6 && ((info[1] >> 5) & 1);
+  return (xcr0 & 0xe6) == 0xe6 && ((info[1] >> 16) & 1);
+#else
+  __builtin_cpu_init();
+  switch (feature) {
+    case CpuFeature::kSse2:
+      return __builtin_cpu_supports("sse2");
+    case CpuFeature::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case CpuFeature::kAvx512:
+      return __builtin_cpu_supports("avx512f");
+  }
+  return false;
+#endif
+}
+#endif
+
+std::vector<StepKernel> DetectKernels() {
+  std::vector<StepKernel> kernels;
+#if LIFE_X86
+  if (CpuSupports(CpuFeature::kAvx512)) kernels.push_back({"avx512", &kAvx512RowKernels});
+  if (CpuSupports(CpuFeature::kAvx2)) kernels.push_back({"avx2", &kAvx2RowKernels});
+  if (CpuSupports(CpuFeature::kSse2)) kernels.push_back({"sse2", &kSse2RowKernels});
+#endif
+  kernels.push_back({"scalar", &kScalarRowKernels});
+  return kernels;
+}
+
+}  // namespace
+
+const std::vector<StepKernel>& AvailableKernels() {
+  static const std::vector<StepKernel> kernels = DetectKernels();
+  return kernels;
+}
+
+const StepKernel* SelectKernel(std::string_view name) {
+  const std::vector<StepKernel>& kernels = AvailableKernels();
+  if (name.empty()) return &kernels.front();
+  for (const StepKernel& kernel : kernels) {
+    if (name == kernel.name) return &kernel;
+  }
+  return nullptr;
+}
+
+const RowKernelSet kScalarRowKernels = {StepRowWords<ConwayRule>, StepRowWords<HighLifeRule>, StepRowWords<SeedsRule>,
+                                        StepRowWords<DayAndNightRule>, StepRowWords<GenericRule>};
+
+void StepRowScalar(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, int begin,
+                   int end, const Rule& rule) {
+  StepRowWords<GenericRule>(above, row, below, out, begin, end, rule);
+}
+
+void StepRows(RowKernel kernel, const Rule& rule, const Board& src, Board* dst, int yBegin, int yEnd, int wordBegin,
+              int wordEnd) {
+  const int height = src.Height();
+  const int words = src.WordsPerRow();
+  const int interiorBegin = std::max(wordBegin, 1);
+  const int interiorEnd = std::min(wordEnd, words - 1);
+  for (int y = yBegin; y < yEnd; ++y) {
+    const uint64_t* above = src.Row(y == 0 ? height - 1 : y - 1);
+    const uint64_t* row = src.Row(y);
+    const uint64_t* below = src.Row(y == height - 1 ? 0 : y + 1);
+    uint64_t* out = dst->Row(y);
+    if (wordBegin == 0) StepEdgeWord(rule, src, above, row, below, out, 0);
+    if (interiorBegin < interiorEnd) kernel(above, row, below, out, interiorBegin, interiorEnd, rule);
+    if (wordEnd == words && words > 1) StepEdgeWord(rule, src, above, row, below, out, words - 1);
+  }
+}
+
+void StepBoard(RowKernel kernel, const Rule& rule, const Board& src, Board* dst) {
+  StepRows(kernel, rule, src, dst, 0, src.Height(), 0, src.WordsPerRow());
+}
+
+void StepPaddedRows(RowKernel kernel, const Rule& rule, const PaddedBoard& src, PaddedBoard* dst, int yBegin, int yEnd,
+                    int wordBegin, int wordEnd) {
+  const bool lastWord = wordEnd == src.WordsPerRow() && wordBegin < wordEnd;
+  for (int y = yBegin; y < yEnd; ++y) {
+    uint64_t* out = dst->Row(y);
+    kernel(src.Row(y - 1), src.Row(y), src.Row(y + 1), out, wordBegin, wordEnd, rule);
+    // The padding bits came out of the ghost cells and are not cells themselves
+    if (lastWord) out[wordEnd - 1] &= src.TailMask();
+  }
+}
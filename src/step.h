@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "board.h"
+#include "padded_board.h"
+#include "rule.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LIFE_X86 1
+#else
+#define LIFE_X86 0
+#endif
+
+// Computes next-generation words [begin, end) of one row from the packed rows above, at and below it. Kernels only
+// handle interior words: they read words begin - 1 through end, so callers guarantee those exist. On a Board that
+// means begin >= 1 and end <= wordsPerRow - 1, and StepRows handles the first and last words, which need the toroidal
+// wrap; on a PaddedBoard the ghost words make every word interior.
+// Kernels specialized for one rule ignore `rule`; the generic ones evaluate it.
+using RowKernel = void (*)(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, int begin,
+                           int end, const Rule& rule);
+
+// One instruction set's kernels, indexed by RuleFamily
+using RowKernelSet = std::array<RowKernel, kRuleFamilyCount>;
+
+// Portable 64-cells-per-word kernels
+extern const RowKernelSet kScalarRowKernels;
+
+#if LIFE_X86
+// Vector kernels, each set compiled in its own translation unit with the matching instruction set enabled. Only call
+// them after checking CPU support (see AvailableKernels).
+extern const RowKernelSet kSse2RowKernels;
+extern const RowKernelSet kAvx2RowKernels;
+extern const RowKernelSet kAvx512RowKernels;
+#endif
+
+// Portable kernel for any rule
+void StepRowScalar(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, int begin,
+                   int end, const Rule& rule);
+
+struct StepKernel {
+  const char* name;
+  const RowKernelSet* rowKernels;
+
+  // The specialized kernel for `rule` if there is one, otherwise the generic kernel
+  RowKernel ForRule(const Rule& rule) const { return (*rowKernels)[static_cast<int>(ClassifyRule(rule))]; }
+};
+
+// Kernels compiled into this build that the running CPU supports, fastest first. The scalar kernel is always last.
+const std::vector<StepKernel>& AvailableKernels();
+
+// The fastest supported kernel, or the one called `name` when it is not empty. Returns nullptr when `name` is unknown
+// or not supported by this CPU.
+const StepKernel* SelectKernel(std::string_view name);
+
+// Steps rows [yBegin, yEnd) and words [wordBegin, wordEnd) of `dst` from `src` under `rule` on a torus, using
+// `kernel` (which must be one made for `rule`) for interior words.
+void StepRows(RowKernel kernel, const Rule& rule, const Board& src, Board* dst, int yBegin, int yEnd, int wordBegin,
+              int wordEnd);
+
+// Steps the whole board
+void StepBoard(RowKernel kernel, const Rule& rule, const Board& src, Board* dst);
+
+// Same as StepRows on boards with ghost cells, which must be fresh (see PaddedBoard::RefreshGhosts). Every word,
+// edges included, goes through `kernel`.
+void StepPaddedRows(RowKernel kernel, const Rule& rule, const PaddedBoard& src, PaddedBoard* dst, int yBegin, int yEnd,
+                    int wordBegin, int wordEnd);
@@ -0,0 +1,28 @@
+#include "step.h"
+
+#if LIFE_X86
+#include <immintrin.h>
+
+#include "step_simd.h"
+
+namespace {
+
+struct Avx2Word {
+  static constexpr int kLanes = 4;
+  __m256i v;
+
+  static Avx2Word Load(const uint64_t* p) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))}; }
+  static void Store(uint64_t* p, Avx2Word w) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), w.v); }
+  static Avx2Word ShiftLeft(Avx2Word w, int n) { return {_mm256_slli_epi64(w.v, n)}; }
+  static Avx2Word ShiftRight(Avx2Word w, int n) { return {_mm256_srli_epi64(w.v, n)}; }
+};
+
+inline Avx2Word operator&(Avx2Word a, Avx2Word b) { return {_mm256_and_si256(a.v, b.v)}; }
+inline Avx2Word operator|(Avx2Word a, Avx2Word b) { return {_mm256_or_si256(a.v, b.v)}; }
+inline Avx2Word operator^(Avx2Word a, Avx2Word b) { return {_mm256_xor_si256(a.v, b.v)}; }
+inline Avx2Word operator~(Avx2Word a) { return {_mm256_xor_si256(a.v, _mm256_set1_epi32(-1))}; }
+
+}  // namespace
+
+const RowKernelSet kAvx2RowKernels = VectorRowKernels<Avx2Word>();
+#endif
@@ -0,0 +1,30 @@
+#include "step.h"
+
+#if LIFE_X86
+#include <immintrin.h>
+
+#include "step_simd.h"
+
+namespace {
+
+struct Avx512Word {
+  static constexpr int kLanes = 8;
+  __m512i v;
+
+  static Avx512Word Load(const uint64_t* p) { return {_mm512_loadu_si512(p)}; }
+  static void Store(uint64_t* p, Avx512Word w) { _mm512_storeu_si512(p, w.v); }
+  // The zero-masked forms with every lane selected compile to the same vpsllq/vpsrlq; the plain ones pass GCC 12 an
+  // undefined merge source, which it reports as a false -Wmaybe-uninitialized at every call
+  static Avx512Word ShiftLeft(Avx512Word w, int n) { return {_mm512_maskz_slli_epi64(0xff, w.v, n)}; }
+  static Avx512Word ShiftRight(Avx512Word w, int n) { return {_mm512_maskz_srli_epi64(0xff, w.v, n)}; }
+};
+
+inline Avx512Word operator&(Avx512Word a, Avx512Word b) { return {_mm512_and_si512(a.v, b.v)}; }
+inline Avx512Word operator|(Avx512Word a, Avx512Word b) { return {_mm512_or_si512(a.v, b.v)}; }
+inline Avx512Word operator^(Avx512Word a, Avx512Word b) { return {_mm512_xor_si512(a.v, b.v)}; }
+inline Avx512Word operator~(Avx512Word a) { return {_mm512_xor_si512(a.v, _mm512_set1_epi32(-1))}; }
+
+}  // namespace
+
+const RowKernelSet kAvx512RowKernels = VectorRowKernels<Avx512Word>();
+#endif
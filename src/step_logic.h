@@ -0,0 +1,115 @@
+#pragma once
+
+#include "rule.h"
+
+// Bit-sliced Game of Life logic shared by every step kernel. `V` is any word type supporting &, |, ^ and ~ (a plain
+// uint64_t for the scalar kernel, a SIMD register wrapper for the vector kernels), so each bit position is an
+// independent cell and one call advances a whole word of cells without branches.
+//
+// The eight neighbor planes are the rows above and below shifted left/centre/right plus the current row shifted
+// left/right. The neighbor count is summed with full adders into four bit planes holding 0..8.
+
+template <class V>
+struct NeighborCount {
+  V bit0;
+  V bit1;
+  V bit2;
+  V bit3;
+};
+
+template <class V>
+inline NeighborCount<V> CountNeighbors(V aboveLeft, V above, V aboveRight, V left, V right, V belowLeft, V below,
+                                       V belowRight) {
+  // Row sums: above and below are 0..3 (two bits), the middle row 0..2
+  const V aboveXor = aboveLeft ^ above;
+  const V above0 = aboveXor ^ aboveRight;
+  const V above1 = (aboveLeft & above) | (aboveRight & aboveXor);
+  const V belowXor = belowLeft ^ below;
+  const V below0 = belowXor ^ belowRight;
+  const V below1 = (belowLeft & below) | (belowRight & belowXor);
+  const V middle0 = left ^ right;
+  const V middle1 = left & right;
+
+  // Ones column, carrying into the twos column
+  const V onesXor = above0 ^ below0;
+  const V ones = onesXor ^ middle0;
+  const V onesCarry = (above0 & below0) | (middle0 & onesXor);
+
+  // Twos column, carrying into the fours column
+  const V twosXor = above1 ^ below1;
+  const V twosSum = twosXor ^ middle1;
+  const V twosCarry = (above1 & below1) | (middle1 & twosXor);
+  const V twos = twosSum ^ onesCarry;
+  const V fours = twosSum & onesCarry;
+
+  return {ones, twos, twosCarry ^ fours, twosCarry & fours};
+}
+
+// Rule logic: each struct maps the neighbor count planes and the current cells to the next generation. The common
+// rules are spelled out as a handful of bitwise operations; GenericRule evaluates any rule from its 9-bit birth and
+// survival tables. `kFamily` indexes the per-instruction-set kernel tables (see RowKernelSet).
+
+// Mask of the cells whose neighbor count is exactly n
+template <class V>
+inline V CountIs(const NeighborCount<V>& count, int n) {
+  return ((n & 1) ? count.bit0 : ~count.bit0) & ((n & 2) ? count.bit1 : ~count.bit1) &
+         ((n & 4) ? count.bit2 : ~count.bit2) & ((n & 8) ? count.bit3 : ~count.bit3);
+}
+
+// B3/S23: a cell is alive next generation with exactly 3 neighbors, or with 2 if it is alive now
+struct ConwayRule {
+  static constexpr RuleFamily kFamily = RuleFamily::kConway;
+  template <class V>
+  static V Next(const NeighborCount<V>& count, V alive, const Rule&) {
+    return count.bit1 & ~count.bit2 & ~count.bit3 & (count.bit0 | alive);
+  }
+};
+
+// B36/S23: Conway plus birth on 6 (0110), which shares bit1 with 2 and 3
+struct HighLifeRule {
+  static constexpr RuleFamily kFamily = RuleFamily::kHighLife;
+  template <class V>
+  static V Next(const NeighborCount<V>& count, V alive, const Rule&) {
+    return count.bit1 & ~count.bit3 & ((~count.bit2 & (count.bit0 | alive)) | (count.bit2 & ~count.bit0 & ~alive));
+  }
+};
+
+// B2/S: only dead cells with exactly 2 neighbors are alive next generation
+struct SeedsRule {
+  static constexpr RuleFamily kFamily = RuleFamily::kSeeds;
+  template <class V>
+  static V Next(const NeighborCount<V>& count, V alive, const Rule&) {
+    return ~alive & count.bit1 & ~count.bit0 & ~count.bit2 & ~count.bit3;
+  }
+};
+
+// B3678/S34678: counts 3, 6, 7 and 8 are alive either way, 4 only keeps live cells alive. Bit 3 is only ever set for
+// a count of 8, whose other planes are zero.
+struct DayAndNightRule {
+  static constexpr RuleFamily kFamily = RuleFamily::kDayAndNight;
+  template <class V>
+  static V Next(const NeighborCount<V>& count, V alive, const Rule&) {
+    return count.bit3 | (count.bit1 & (count.bit2 | count.bit0)) | (alive & count.bit2 & ~count.bit1 & ~count.bit0);
+  }
+};
+
+// Any rule: ORs together the exact-count masks selected by the birth and survival tables
+struct GenericRule {
+  static constexpr RuleFamily kFamily = RuleFamily::kGeneric;
+  template <class V>
+  static V Next(const NeighborCount<V>& count, V alive, const Rule& rule) {
+    V next = alive & ~alive;
+    for (int n = 0; n <= 8; ++n) {
+      const bool birth = (rule.birth >> n) & 1;
+      const bool survival = (rule.survival >> n) & 1;
+      if (birth && survival) {
+        next = next | CountIs(count, n);
+      } else if (birth) {
+        next = next | (CountIs(count, n) & ~alive);
+      } else if (survival) {
+        next = next | (CountIs(count, n) & alive);
+      }
+    }
+    return next;
+  }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+// Generic vector row kernel used by the per-ISA step kernels. Each ISA translation unit defines a register wrapper
+// type inside an anonymous namespace and instantiates StepRowVector with it once per rule family (see
+// VectorRowKernels), so nothing compiled with wider instruction sets can leak into code that runs before dispatch.
+//
+// A wrapper `V` provides:
+//   static constexpr int kLanes;                 // 64-bit words per register
+//   static V Load(const uint64_t*);              // unaligned load
+//   static void Store(uint64_t*, V);             // unaligned store
+//   static V ShiftLeft(V, int), ShiftRight(V, int) (per 64-bit lane)
+//   operators &, |, ^, ~
+
+#include <cstdint>
+
+#include "step.h"
+#include "step_logic.h"
+
+template <class V, class Logic>
+void StepRowVector(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out, int begin, int end,
+                   const Rule& rule) {
+  int i = begin;
+  for (; i + V::kLanes <= end; i += V::kLanes) {
+    // Lane j of the unaligned loads at i - 1 and i + 1 holds the words either side of word i + j
+    const V aboveWord = V::Load(above + i);
+    const V rowWord = V::Load(row + i);
+    const V belowWord = V::Load(below + i);
+    const V aboveLeft = V::ShiftLeft(aboveWord, 1) | V::ShiftRight(V::Load(above + i - 1), 63);
+    const V aboveRight = V::ShiftRight(aboveWord, 1) | V::ShiftLeft(V::Load(above + i + 1), 63);
+    const V left = V::ShiftLeft(rowWord, 1) | V::ShiftRight(V::Load(row + i - 1), 63);
+    const V right = V::ShiftRight(rowWord, 1) | V::ShiftLeft(V::Load(row + i + 1), 63);
+    const V belowLeft = V::ShiftLeft(belowWord, 1) | V::ShiftRight(V::Load(below + i - 1), 63);
+    const V belowRight = V::ShiftRight(belowWord, 1) | V::ShiftLeft(V::Load(below + i + 1), 63);
+    const NeighborCount<V> count =
+        CountNeighbors(aboveLeft, aboveWord, aboveRight, left, right, belowLeft, belowWord, belowRight);
+    V::Store(out + i, Logic::Next(count, rowWord, rule));
+  }
+  if (i < end) kScalarRowKernels[static_cast<int>(Logic::kFamily)](above, row, below, out, i, end, rule);
+}
+
+template <class V>
+constexpr RowKernelSet VectorRowKernels() {
+  return {StepRowVector<V, ConwayRule>, StepRowVector<V, HighLifeRule>, StepRowVector<V, SeedsRule>,
+          StepRowVector<V, DayAndNightRule>, StepRowVector<V, GenericRule>};
+}
@@ -0,0 +1,28 @@
+#include "step.h"
+
+#if LIFE_X86
+#include <emmintrin.h>
+
+#include "step_simd.h"
+
+namespace {
+
+struct Sse2Word {
+  static constexpr int kLanes = 2;
+  __m128i v;
+
+  static Sse2Word Load(const uint64_t* p) { return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))}; }
+  static void Store(uint64_t* p, Sse2Word w) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), w.v); }
+  static Sse2Word ShiftLeft(Sse2Word w, int n) { return {_mm_slli_epi64(w.v, n)}; }
+  static Sse2Word ShiftRight(Sse2Word w, int n) { return {_mm_srli_epi64(w.v, n)}; }
+};
+
+inline Sse2Word operator&(Sse2Word a, Sse2Word b) { return {_mm_and_si128(a.v, b.v)}; }
+inline Sse2Word operator|(Sse2Word a, Sse2Word b) { return {_mm_or_si128(a.v, b.v)}; }
+inline Sse2Word operator^(Sse2Word a, Sse2Word b) { return {_mm_xor_si128(a.v, b.v)}; }
+inline Sse2Word operator~(Sse2Word a) { return {_mm_xor_si128(a.v, _mm_set1_epi32(-1))}; }
+
+}  // namespace
+
+const RowKernelSet kSse2RowKernels = VectorRowKernels<Sse2Word>();
+#endif
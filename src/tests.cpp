@@ -0,0 +1,830 @@
+// Correctness checks run by ctest: kernels and engines against brute-force references or each other, image and density
+// conversions against per-cell ones, and pattern files through save and load round trips. Prints every failed check
+// and exits with 1 if there was any.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "density_pyramid.h"
+#include "generations_engine.h"
+#include "hashlife.h"
+#include "larger_than_life.h"
+#include "macrocell_file.h"
+#include "packed_engine.h"
+#include "padded_board.h"
+#include "rle_file.h"
+#include "rule.h"
+#include "simulation_thread.h"
+#include "sparse_engine.h"
+#include "step.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const std::string& what) {
+  if (condition) return;
+  std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+  ++failures;
+}
+
+// Widths around the 64-cell word, where the kernels' edge words, tail masks and wrap differ
+constexpr int kTestWidths[] = {1, 63, 64, 65, 130};
+
+// Rules of every RuleFamily: the four with their own kernels, then two generic ones
+const char* const kTestRules[] = {"B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B36/S125", "B1357/S02468"};
+
+// One Life-like generation on a torus, counting every neighborhood cell by cell
+Board StepLifeBruteForce(const Board& board, const Rule& rule) {
+  const int width = board.Width();
+  const int height = board.Height();
+  Board next(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      int neighbors = 0;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          if (dx != 0 || dy != 0) neighbors += board.Get((x + dx + width) % width, (y + dy + height) % height);
+        }
+      }
+      next.Set(x, y, ((board.Get(x, y) ? rule.survival : rule.birth) >> neighbors) & 1);
+    }
+  }
+  return next;
+}
+
+void CheckStepKernels() {
+  std::string error;
+  uint64_t seed = 100;
+  bool familyTested[kRuleFamilyCount] = {};
+  for (const char* ruleText : kTestRules) {
+    Rule rule;
+    Check(ParseRule(ruleText, &rule, &error), std::string(ruleText) + " parses");
+    familyTested[static_cast<int>(ClassifyRule(rule))] = true;
+    for (const StepKernel& kernel : AvailableKernels()) {
+      // The generic kernel, and the rule's specialized one where it has its own
+      const RowKernel generic = (*kernel.rowKernels)[static_cast<int>(RuleFamily::kGeneric)];
+      for (const RowKernel rowKernel : {generic, kernel.ForRule(rule)}) {
+        const std::string name = std::string(kernel.name) + (rowKernel == generic ? " generic" : " specialized") +
+                                 " kernel, " + ruleText;
+        for (const int width : kTestWidths) {
+          for (const int height : {1, 5, 33}) {
+            Board board = RandomBoard(width, height, 0.4, seed++);
+            Board next(width, height);
+            for (int generation = 1; generation <= 3; ++generation) {
+              StepBoard(rowKernel, rule, board, &next);
+              if (!(next == StepLifeBruteForce(board, rule))) {
+                Check(false, name + " on " + std::to_string(width) + "x" + std::to_string(height) + ", generation " +
+                                 std::to_string(generation));
+                break;
+              }
+              std::swap(board, next);
+            }
+          }
+        }
+      }
+    }
+  }
+  Check(std::count(familyTested, familyTested + kRuleFamilyCount, true) == kRuleFamilyCount,
+        "the test rules cover every rule family");
+}
+
+// Steps padded boards in quarters split at odd rows and words, the way tiles split them
+void CheckPaddedRows() {
+  std::string error;
+  uint64_t seed = 300;
+  for (const char* ruleText : kTestRules) {
+    Rule rule;
+    ParseRule(ruleText, &rule, &error);
+    for (const StepKernel& kernel : AvailableKernels()) {
+      for (const int width : kTestWidths) {
+        for (const int height : {1, 5, 33}) {
+          const Board board = RandomBoard(width, height, 0.4, seed++);
+          PaddedBoard padded(board);
+          padded.RefreshGhosts();
+          PaddedBoard next(width, height);
+          const int splitY = height / 2;
+          const int splitWord = padded.WordsPerRow() / 2;
+          for (const auto& rows : {std::pair{0, splitY}, {splitY, height}}) {
+            for (const auto& words : {std::pair{0, splitWord}, {splitWord, padded.WordsPerRow()}}) {
+              StepPaddedRows(kernel.ForRule(rule), rule, padded, &next, rows.first, rows.second, words.first,
+                             words.second);
+            }
+          }
+          Board stepped;
+          next.CopyTo(&stepped);
+          Check(stepped == StepLifeBruteForce(board, rule),
+                std::string(kernel.name) + " kernel on padded rows, " + ruleText + " on " + std::to_string(width) +
+                    "x" + std::to_string(height));
+        }
+      }
+    }
+  }
+}
+
+void CheckPackedEngine() {
+  std::string error;
+  uint64_t seed = 200;
+  for (const char* ruleText : kTestRules) {
+    Rule rule;
+    ParseRule(ruleText, &rule, &error);
+    for (const int width : kTestWidths) {
+      // Several 64x64 tiles, and a single row
+      for (const int height : {1, 70}) {
+        const Board initial = RandomBoard(width, height, 0.3, seed++);
+        std::vector<Board> expected = {initial};
+        for (int generation = 1; generation <= 4; ++generation) {
+          expected.push_back(StepLifeBruteForce(expected.back(), rule));
+        }
+        for (const StepKernel& kernel : AvailableKernels()) {
+          for (const Schedule schedule : {Schedule::kStripes, Schedule::kTiles}) {
+            for (const bool skipStableTiles : {false, true}) {
+              if (schedule == Schedule::kStripes && skipStableTiles) continue;
+              const char* scheduleName = schedule == Schedule::kStripes ? "stripes"
+                                         : skipStableTiles              ? "active tiles"
+                                                                        : "tiles";
+              for (const int threads : {1, 3}) {
+                PackedEngineOptions options;
+                options.kernel = kernel.ForRule(rule);
+                options.rule = rule;
+                options.threads = threads;
+                options.schedule = schedule;
+                options.tileSize = 64;
+                options.skipStableTiles = skipStableTiles;
+                PackedEngine engine(initial, options);
+                for (int generation = 1; generation <= 4; ++generation) {
+                  engine.Step();
+                  if (!(engine.View() == expected[generation])) {
+                    Check(false, std::string(kernel.name) + " packed engine with " + scheduleName + ", " + ruleText +
+                                     " on " + std::to_string(width) + "x" + std::to_string(height) + " with " +
+                                     std::to_string(threads) + " threads, generation " + std::to_string(generation));
+                    break;
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // A glider crossing tile edges and the wrap, next to a blinker, among tiles that stay blank: only the tiles around
+  // them are stepped
+  Board glider(5, 5);
+  for (const auto& cell : {std::pair{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}}) glider.Set(cell.first, cell.second, true);
+  Board expected = PlaceBoard(glider, 300, 200, 250, 150);
+  for (int x = 100; x < 103; ++x) expected.Set(x, 40, true);
+  PackedEngineOptions options;
+  options.tileSize = 64;
+  options.threads = 3;
+  PackedEngine engine(expected, options);
+  bool skipped = false;
+  for (int generation = 1; generation <= 240; ++generation) {
+    engine.Step();
+    expected = StepLifeBruteForce(expected, kConwayRule);
+    skipped = skipped || engine.ActiveTileCount() < engine.TileCount();
+    if (!(engine.View() == expected)) {
+      Check(false, "active tiles follow a glider, generation " + std::to_string(generation));
+      break;
+    }
+  }
+  Check(skipped, "stable tiles are skipped");
+}
+
+// Cell states of a Generations board: 0 dead, 1 alive, 2 and up dying, row by row
+std::vector<int> StatesOf(const Board& alive, const std::vector<Board>& ages) {
+  std::vector<int> states;
+  for (int y = 0; y < alive.Height(); ++y) {
+    for (int x = 0; x < alive.Width(); ++x) {
+      int age = 0;
+      for (size_t k = 0; k < ages.size(); ++k) age |= ages[k].Get(x, y) << k;
+      states.push_back(alive.Get(x, y) ? 1 : age == 0 ? 0 : age + 1);
+    }
+  }
+  return states;
+}
+
+// One Generations step on a torus, cell by cell
+std::vector<int> StepGenerationsBruteForce(const std::vector<int>& states, int width, int height, const Rule& rule) {
+  std::vector<int> next(states.size());
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      int neighbors = 0;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          if (dx == 0 && dy == 0) continue;
+          neighbors += states[(y + dy + height) % height * width + (x + dx + width) % width] == 1;
+        }
+      }
+      const int state = states[y * width + x];
+      int& cell = next[y * width + x];
+      if (state == 0) {
+        cell = (rule.birth >> neighbors) & 1;
+      } else if (state == 1) {
+        cell = (rule.survival >> neighbors) & 1 ? 1 : 2;
+      } else {
+        cell = (state + 1) % rule.states;
+      }
+    }
+  }
+  return next;
+}
+
+void CheckGenerations() {
+  std::string error;
+  uint64_t seed = 400;
+  for (const char* ruleText : {"B2/S/C3", "B2/S345/C4", "B3/S23/C4", "B36/S125/C7", "B2/S/C40"}) {
+    Rule rule;
+    Check(ParseRule(ruleText, &rule, &error), std::string(ruleText) + " parses");
+    for (const StepKernel& kernel : AvailableKernels()) {
+      for (const int width : kTestWidths) {
+        for (const int height : {1, 33}) {
+          for (const int threads : {1, 3}) {
+            const std::string name = std::string(kernel.name) + " kernel, " + ruleText + " on " +
+                                     std::to_string(width) + "x" + std::to_string(height) + " with " +
+                                     std::to_string(threads) + " threads";
+            const Board initial = RandomBoard(width, height, 0.4, seed++);
+            GenerationsEngine engine(initial, GenerationsEngineOptions{kernel.ForRule(rule), rule, threads});
+            std::vector<int> expected = StatesOf(initial, {});
+            // Long enough for the first dying cells to decay all the way
+            for (int generation = 1; generation <= 45; ++generation) {
+              engine.Step();
+              expected = StepGenerationsBruteForce(expected, width, height, rule);
+              if (StatesOf(engine.View(), engine.ViewAges()) != expected) {
+                Check(false, name + ", generation " + std::to_string(generation));
+                break;
+              }
+            }
+            // Grayscale levels of a window at an odd offset against each cell's state: dying cells fall evenly from
+            // just under 255
+            const std::vector<int> states = StatesOf(engine.View(), engine.ViewAges());
+            const int steps = rule.states - 1;
+            const int left = width / 3;
+            const int top = height / 2;
+            std::vector<uint8_t> pixels(static_cast<size_t>(width - left) * (height - top));
+            StatesToGrayscale(engine.View(), engine.ViewAges(), rule.states, left, top, width - left, height - top,
+                              pixels.data());
+            bool matches = true;
+            for (int y = top; y < height; ++y) {
+              for (int x = left; x < width; ++x) {
+                const int state = states[y * width + x];
+                const int level = state == 1 ? 255 : state == 0 ? 0 : (steps - (state - 1)) * (255 * 256 / steps) >> 8;
+                matches = matches && pixels[(y - top) * (width - left) + (x - left)] == level;
+              }
+            }
+            Check(matches, name + ", grayscale");
+          }
+        }
+      }
+    }
+  }
+}
+
+// Every block count at every level of `pyramid` against the board's live cells counted one by one
+bool PyramidMatches(const DensityPyramid& pyramid, const Board& board) {
+  for (int level = DensityPyramid::kBaseLevel; level <= pyramid.TopLevel(); ++level) {
+    const int block = 1 << level;
+    if (pyramid.BlocksX(level) != (board.Width() + block - 1) / block ||
+        pyramid.BlocksY(level) != (board.Height() + block - 1) / block) {
+      return false;
+    }
+    for (int blockY = 0; blockY < pyramid.BlocksY(level); ++blockY) {
+      for (int blockX = 0; blockX < pyramid.BlocksX(level); ++blockX) {
+        uint64_t count = 0;
+        for (int y = blockY * block; y < std::min((blockY + 1) * block, board.Height()); ++y) {
+          for (int x = blockX * block; x < std::min((blockX + 1) * block, board.Width()); ++x) count += board.Get(x, y);
+        }
+        if (pyramid.Count(level, blockX, blockY) != count) return false;
+      }
+    }
+  }
+  return pyramid.BlocksX(pyramid.TopLevel()) == 1 && pyramid.BlocksY(pyramid.TopLevel()) == 1;
+}
+
+void CheckDensityPyramid() {
+  uint64_t seed = 500;
+  for (const int width : kTestWidths) {
+    for (const int height : {1, 70}) {
+      const std::string size = std::to_string(width) + "x" + std::to_string(height);
+      Board board = RandomBoard(width, height, 0.3, seed++);
+      DensityPyramid pyramid(board);
+      Check(PyramidMatches(pyramid, board), "density pyramid built on " + size);
+
+      // Cells flipped at random, each reported as a rectangle around it, some reaching past the board's edges
+      for (int round = 0; round < 20; ++round) {
+        std::vector<CellRect> changed;
+        for (int i = 0; i < 3; ++i) {
+          const int x = static_cast<int>((seed * 7 + i * 13) % width);
+          const int y = static_cast<int>((seed * 11 + i * 5) % height);
+          ++seed;
+          board.Set(x, y, !board.Get(x, y));
+          changed.push_back(CellRect{x - i * 9, y - i, 1 + i * 20, 1 + i * 3});
+        }
+        pyramid.Update(board, changed);
+      }
+      Check(PyramidMatches(pyramid, board), "density pyramid updated from flipped cells on " + size);
+
+      // The packed engine's changed tiles keep it in sync generation after generation
+      PackedEngineOptions options;
+      options.tileSize = 64;
+      PackedEngine engine(board, options);
+      std::vector<CellRect> changed;
+      for (int generation = 1; generation <= 30; ++generation) {
+        engine.Step();
+        changed.clear();
+        engine.TakeChangedRegions(&changed);
+        pyramid.Update(engine.View(), changed);
+      }
+      Check(PyramidMatches(pyramid, engine.View()), "density pyramid updated from changed tiles on " + size);
+    }
+  }
+  // A board of another size rebuilds it
+  DensityPyramid pyramid(RandomBoard(64, 64, 0.5, 1));
+  const Board other = RandomBoard(100, 9, 0.5, 2);
+  pyramid.Update(other, {});
+  Check(PyramidMatches(pyramid, other), "density pyramid rebuilt for a new board size");
+}
+
+// Frames published from the packed engine's changed tiles alone, while the renderer holds on to some of them
+void CheckSimulationThread() {
+  constexpr uint64_t kGenerations = 400;
+  Board initial = PlaceBoard(RandomBoard(40, 40, 0.4, 1), 300, 200, 20, 20);
+  for (int x = 200; x < 203; ++x) initial.Set(x, 150, true);
+  PackedEngineOptions options;
+  options.tileSize = 64;
+  PackedEngine reference(initial, options);
+  std::vector<Board> expected = {reference.View()};
+  for (uint64_t generation = 1; generation <= kGenerations; ++generation) {
+    reference.Step();
+    expected.push_back(reference.View());
+  }
+
+  PackedEngine engine(initial, options);
+  SimulationThread thread(&engine, 0, 1, 0.0001, kGenerations);
+  bool matches = true;
+  for (int poll = 0;; ++poll) {
+    const SimulationFrame& frame = thread.Latest();
+    matches = matches && frame.board == expected[frame.generation] && PyramidMatches(frame.density, frame.board);
+    if (frame.generation == kGenerations) break;
+    std::this_thread::sleep_for(std::chrono::microseconds(poll % 7 * 300));
+  }
+  Check(matches, "simulation thread frames match the engine");
+}
+
+// Deterministic noise for image pixels
+std::vector<uint8_t> RandomBytes(size_t count, uint64_t seed) {
+  std::vector<uint8_t> bytes(count);
+  for (uint8_t& byte : bytes) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    byte = static_cast<uint8_t>(seed >> 56);
+  }
+  return bytes;
+}
+
+void CheckImageImport() {
+  uint64_t seed = 600;
+  for (const int width : kTestWidths) {
+    for (const int height : {1, 3}) {
+      const std::string size = std::to_string(width) + "x" + std::to_string(height);
+      for (const int bytesPerPixel : {1, 2, 3, 4}) {
+        const std::vector<uint8_t> pixels = RandomBytes(static_cast<size_t>(width) * height * bytesPerPixel, seed++);
+        for (int channel = 0; channel < bytesPerPixel; ++channel) {
+          for (const int threshold : {0, 1, 128, 255}) {
+            Board expected(width, height);
+            for (int y = 0; y < height; ++y) {
+              for (int x = 0; x < width; ++x) {
+                expected.Set(x, y, pixels[(static_cast<size_t>(y) * width + x) * bytesPerPixel + channel] >= threshold);
+              }
+            }
+            const Board board =
+                BoardFromChannel(pixels.data(), width, height, bytesPerPixel, channel, static_cast<uint8_t>(threshold));
+            Check(board == expected,
+                  "channel " + std::to_string(channel) + " of " + std::to_string(bytesPerPixel) +
+                      "-byte pixels at threshold " + std::to_string(threshold) + " on " + size);
+          }
+        }
+      }
+
+      const std::vector<uint8_t> rgb = RandomBytes(static_cast<size_t>(width) * height * 3, seed++);
+      for (const int threshold : {0, 1, 100, int{kLumaThreshold}, 255}) {
+        Board expected(width, height);
+        for (int y = 0; y < height; ++y) {
+          for (int x = 0; x < width; ++x) {
+            const uint8_t* pixel = &rgb[(static_cast<size_t>(y) * width + x) * 3];
+            expected.Set(x, y, (pixel[0] * 77 + pixel[1] * 150 + pixel[2] * 29) >> 8 >= threshold);
+          }
+        }
+        Check(BoardFromRgbLuma(rgb.data(), width, height, static_cast<uint8_t>(threshold)) == expected,
+              "RGB luma at threshold " + std::to_string(threshold) + " on " + size);
+      }
+    }
+  }
+  // Pure white and black are the extremes of the luma weights
+  const uint8_t whiteAndBlack[] = {255, 255, 255, 0, 0, 0};
+  const Board luma = BoardFromRgbLuma(whiteAndBlack, 2, 1, 255);
+  Check(luma.Get(0, 0) && !luma.Get(1, 0), "white is brightest and black darkest in luma");
+}
+
+void CheckImageExport() {
+  constexpr Rgba kAlive{255, 200, 0, 255};
+  constexpr Rgba kDead{10, 20, 30, 40};
+  // Written past the window would show up here
+  constexpr uint8_t kGuard = 0x5a;
+  constexpr size_t kGuardBytes = 64;
+  uint64_t seed = 700;
+  for (const int width : kTestWidths) {
+    const Board board = RandomBoard(width, 3, 0.5, seed++);
+    for (const int left : {0, width / 3, width - 1}) {
+      for (const int top : {0, 2}) {
+        const int cells = width - left;
+        const int rows = 3 - top;
+        const std::string window = std::to_string(cells) + "x" + std::to_string(rows) + " at " +
+                                   std::to_string(left) + "," + std::to_string(top) + " of " + std::to_string(width) +
+                                   "x3";
+        std::vector<uint8_t> gray(static_cast<size_t>(cells) * rows + kGuardBytes, kGuard);
+        std::vector<uint8_t> rgba(static_cast<size_t>(cells) * rows * 4 + kGuardBytes, kGuard);
+        BoardToGrayscale(board, left, top, cells, rows, gray.data());
+        BoardToRgba(board, left, top, cells, rows, kAlive, kDead, rgba.data());
+        bool grayMatches = true;
+        bool rgbaMatches = true;
+        for (int y = 0; y < rows; ++y) {
+          for (int x = 0; x < cells; ++x) {
+            const bool alive = board.Get(left + x, top + y);
+            const size_t pixel = static_cast<size_t>(y) * cells + x;
+            const Rgba color = alive ? kAlive : kDead;
+            grayMatches = grayMatches && gray[pixel] == (alive ? 255 : 0);
+            rgbaMatches = rgbaMatches && rgba[pixel * 4] == color.r && rgba[pixel * 4 + 1] == color.g &&
+                          rgba[pixel * 4 + 2] == color.b && rgba[pixel * 4 + 3] == color.a;
+          }
+        }
+        const auto guarded = [](const std::vector<uint8_t>& pixels) {
+          return std::all_of(pixels.end() - kGuardBytes, pixels.end(), [](uint8_t byte) { return byte == kGuard; });
+        };
+        Check(grayMatches && guarded(gray), "grayscale of " + window);
+        Check(rgbaMatches && guarded(rgba), "RGBA of " + window);
+      }
+    }
+  }
+}
+
+// One Larger than Life generation on a torus, summing every neighborhood cell by cell
+Board StepLargerThanLifeBruteForce(const Board& board, const LargerThanLifeRule& rule) {
+  const int width = board.Width();
+  const int height = board.Height();
+  Board next(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      int total = 0;
+      for (int dy = -rule.radius; dy <= rule.radius; ++dy) {
+        for (int dx = -rule.radius; dx <= rule.radius; ++dx) {
+          if (rule.neighborhood == Neighborhood::kVonNeumann && std::abs(dx) + std::abs(dy) > rule.radius) continue;
+          if (!rule.includeCenter && dx == 0 && dy == 0) continue;
+          total += board.Get(((x + dx) % width + width) % width, ((y + dy) % height + height) % height);
+        }
+      }
+      const bool alive = board.Get(x, y) ? total >= rule.survivalMin && total <= rule.survivalMax
+                                         : total >= rule.birthMin && total <= rule.birthMax;
+      next.Set(x, y, alive);
+    }
+  }
+  return next;
+}
+
+void CheckLargerThanLife() {
+  // Boards narrower than the neighborhood wrap it around more than once
+  const int sizes[][2] = {{37, 29}, {64, 70}, {8, 9}};
+  uint64_t seed = 1;
+  for (const int radius : {1, 2, 5}) {
+    for (const Neighborhood neighborhood : {Neighborhood::kMoore, Neighborhood::kVonNeumann}) {
+      for (const bool includeCenter : {false, true}) {
+        const int cells = neighborhood == Neighborhood::kMoore ? (2 * radius + 1) * (2 * radius + 1)
+                                                               : 2 * radius * (radius + 1) + 1;
+        LargerThanLifeRule rule;
+        rule.radius = radius;
+        rule.includeCenter = includeCenter;
+        rule.neighborhood = neighborhood;
+        rule.survivalMin = cells * 2 / 10;
+        rule.survivalMax = cells * 5 / 10;
+        rule.birthMin = cells * 3 / 10;
+        rule.birthMax = cells * 4 / 10;
+        const std::string name = LargerThanLifeRuleString(rule);
+
+        std::string error;
+        LargerThanLifeRule parsed;
+        Check(ParseLargerThanLifeRule(name, &parsed, &error) && parsed == rule, name + " parses back");
+
+        for (const int threads : {1, 3}) {
+          for (const auto& size : sizes) {
+            Board expected = RandomBoard(size[0], size[1], 0.5, seed++);
+            LargerThanLifeEngine engine(expected, LargerThanLifeOptions{rule, threads});
+            for (int generation = 1; generation <= 4; ++generation) {
+              engine.Step();
+              expected = StepLargerThanLifeBruteForce(expected, rule);
+              if (!(engine.View() == expected)) {
+                Check(false, name + " on " + std::to_string(size[0]) + "x" + std::to_string(size[1]) + " with " +
+                                 std::to_string(threads) + " threads, generation " + std::to_string(generation));
+                break;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Glider heading down and to the right, in its first phase
+const char* const kGliderRle = "#N Glider\nx = 3, y = 3, rule = B3/S23\nbo$2bo$3o!\n";
+
+void CheckRle() {
+  std::string rule;
+  std::string error;
+  Board glider;
+  std::vector<Board> ages;
+  Check(ParseRle(kGliderRle, &glider, &ages, &rule, &error), "glider RLE parses");
+  Check(glider.Width() == 3 && glider.Height() == 3 && glider.Population() == 5 && glider.Get(1, 0) &&
+            rule == "B3/S23" && ages.empty(),
+        "glider RLE decodes to its cells and rule");
+
+  // Two-state boards, some with blank rows, survive a round trip with lines of at most 70 characters
+  for (int i = 0; i < 40; ++i) {
+    Board board = RandomBoard(1 + i * 13 % 300, 1 + i * 7 % 90, (i % 5) * 0.25, i);
+    if (i % 3 == 0) {
+      for (int y = 0; y < board.Height(); y += 2) std::fill(board.Row(y), board.Row(y) + board.WordsPerRow(), 0);
+    }
+    const std::string text = RleFromBoard(board, {}, "B3/S23");
+    Board decoded;
+    Check(ParseRle(text, &decoded, &ages, &rule, &error) && decoded == board && ages.empty(),
+          "two-state round trip " + std::to_string(i));
+    size_t lineStart = 0;
+    for (size_t end = text.find('\n'); end != std::string::npos; end = text.find('\n', lineStart)) {
+      Check(end - lineStart <= 70, "RLE line length in round trip " + std::to_string(i));
+      lineStart = end + 1;
+    }
+  }
+
+  // A Generations board saved partway and reloaded carries on exactly like one that ran straight through, also with
+  // more than 24 states, which take two-letter tokens
+  for (const char* ruleText : {"B2/S/C3", "B3/S23/C4", "B2/S/C40"}) {
+    Rule generationsRule;
+    Check(ParseRule(ruleText, &generationsRule, &error), std::string(ruleText) + " parses");
+    const GenerationsEngineOptions options{StepRowScalar, generationsRule, 1};
+    const Board soup = RandomBoard(70, 45, 0.4, 5);
+    GenerationsEngine straight(soup, options);
+    GenerationsEngine saved(soup, options);
+    straight.Advance(60);
+    saved.Advance(30);
+    const std::string text = RleFromBoard(saved.View(), saved.ViewAges(), ruleText);
+    Check(generationsRule.states <= 25 || text.find('p') != std::string::npos,
+          std::string(ruleText) + " writes two-letter tokens");
+    Board decoded;
+    Check(ParseRle(text, &decoded, &ages, &rule, &error) && rule == ruleText, std::string(ruleText) + " RLE parses");
+    GenerationsEngine reloaded(decoded, ages, options);
+    reloaded.Advance(30);
+    Check(reloaded.View() == straight.View() && reloaded.ViewAges() == straight.ViewAges(),
+          std::string(ruleText) + " survives a save and reload");
+  }
+
+  // States past the rule's last one start dead; only state 1 counts on the board itself
+  Board decoded;
+  Check(ParseRle("x = 6, y = 1, rule = B2/S/C4\nABCDpAC!", &decoded, &ages, &rule, &error) &&
+            decoded.Population() == 1 && ages.size() == 5,
+        "multi-state tokens decode");
+  Rule fourStates;
+  ParseRule("B2/S/C4", &fourStates, &error);
+  GenerationsEngine clipped(decoded, ages, GenerationsEngineOptions{StepRowScalar, fourStates, 1});
+  Check(RleFromBoard(clipped.View(), clipped.ViewAges(), "B2/S/C4") == "x = 6, y = 1, rule = B2/S/C4\nABC2.C!\n",
+        "states past the rule's last one are dropped");
+
+  for (const char* bad : {"x = 3\nooo!", "x = 2, y = 1\n3o!", "x = 2, y = 2\n$$o!", "x = 2, y = 1\nz!", ""}) {
+    Check(!ParseRle(bad, &decoded, &ages, &rule, &error), "malformed RLE is rejected: " + std::string(bad));
+  }
+  // Row skips that add up past INT_MAX, each within the run limit
+  std::string skips = "x = 4, y = 4\n";
+  for (int i = 0; i < 129; ++i) skips += "16777216$";
+  Check(!ParseRle(skips + "o!", &decoded, &ages, &rule, &error), "RLE rows skipped past the y size are rejected");
+  Check(ParseRle("x = 2, y = 1\n2o$$!", &decoded, &ages, &rule, &error) && decoded.Population() == 2,
+        "trailing row separators are accepted");
+
+  // The unbounded engines save every live cell, even after the pattern has left the starting window
+  const Board window = PlaceBoard(glider, 16, 16, 0, 0);
+  std::unique_ptr<Engine> engines[] = {std::make_unique<SparseEngine>(window, SparseEngineOptions{}),
+                                       std::make_unique<HashLifeEngine>(window, HashLifeOptions{})};
+  for (const std::unique_ptr<Engine>& engine : engines) {
+    engine->Advance(200);
+    Board exported;
+    Check(engine->View().Population() == 0 && engine->ExportBoard(&exported, &error) &&
+              ParseRle(RleFromBoard(exported, {}, "B3/S23"), &decoded, &ages, &rule, &error) && decoded == glider,
+          std::string(engine->Name()) + " saves a glider that left the window");
+  }
+}
+
+void CheckMacrocell() {
+  std::string rule;
+  std::string error;
+  Quadtree tree;
+  // Golly's glider: one 8x8 leaf in the corner of an otherwise empty level-5 root
+  Check(ParseMacrocell("[M2] (golly 2.0)\n#R B3/S23\n#G 0\n$$..*$...*$.***$$$$\n4 0 0 0 1\n5 0 0 0 2\n", &tree, &rule,
+                       &error) &&
+            rule == "B3/S23",
+        "glider Macrocell parses");
+  Board glider;
+  std::vector<Board> ages;
+  ParseRle(kGliderRle, &glider, &ages, &rule, &error);
+  Check(HashLifeEngine(tree, HashLifeOptions{}).View() == glider, "glider Macrocell decodes to its bounding box");
+
+  // Boards go through HashLife's snapshot, the text and back, and keep stepping alike
+  for (int i = 0; i < 10; ++i) {
+    Board board = RandomBoard(50 + i * 17, 40 + i * 9, 0.3, i);
+    board.Set(0, 0, true);
+    board.Set(board.Width() - 1, board.Height() - 1, true);
+    HashLifeEngine original(board, HashLifeOptions{});
+    Quadtree decoded;
+    Check(ParseMacrocell(MacrocellFromTree(original.Snapshot(), "B3/S23"), &decoded, &rule, &error),
+          "Macrocell round trip " + std::to_string(i) + " parses");
+    HashLifeEngine reloaded(decoded, HashLifeOptions{});
+    Check(reloaded.View() == board, "Macrocell round trip " + std::to_string(i) + " keeps the board");
+    original.Advance(64);
+    reloaded.Advance(64);
+    Board originalCells;
+    Board reloadedCells;
+    Check(original.ExportBoard(&originalCells, &error) && reloaded.ExportBoard(&reloadedCells, &error) &&
+              originalCells == reloadedCells,
+          "Macrocell round trip " + std::to_string(i) + " steps like the original");
+  }
+
+  // Two gliders further apart than View() shows: the view is clipped, but the snapshot keeps both
+  Board apart = PlaceBoard(glider, 20003, 3, 0, 0);
+  for (int y = 0; y < 3; ++y) {
+    for (int x = 0; x < 3; ++x) apart.Set(20000 + x, y, glider.Get(x, y));
+  }
+  Quadtree decoded;
+  Check(ParseMacrocell(MacrocellFromTree(HashLifeEngine(apart, HashLifeOptions{}).Snapshot(), ""), &decoded, &rule,
+                       &error),
+        "distant gliders parse");
+  HashLifeEngine distant(decoded, HashLifeOptions{});
+  Board exported;
+  Check(distant.View().Width() == HashLifeEngine::kMaxTreeView && distant.Population() == 10 &&
+            distant.ExportBoard(&exported, &error) && exported == apart,
+        "distant gliders survive a Macrocell round trip past the view's clipping");
+
+  // Lightweight spaceships flying apart at c/2 end up 2^32 cells apart on a strip a few cells tall: too wide for a
+  // board, however few cells the strip holds
+  Check(ParseRle("x = 16, y = 4\nbo2bo6bo2bo$o14bo$o3bo6bo3bo$4o8b4o!", &apart, &ages, &rule, &error),
+        "spaceship pair parses");
+  HashLifeEngine diverging(apart, HashLifeOptions{});
+  diverging.AdvancePowerOfTwo(33);
+  Check(diverging.Population() == 18 && !diverging.ExportBoard(&exported, &error),
+        "spaceships 2^32 cells apart are too wide to export");
+  // Two blocks at either end of a 2^31-cell strip: within kMaxExportCells, but wider than an int
+  std::string blocks = "[M2]\n**$**$\n......**$......**$\n";
+  // Nodes 3..29 lead down the north-east edge to the right block, nodes 30..56 down the north-west edge to the left
+  for (int level = 4; level <= 30; ++level) {
+    blocks += std::to_string(level) + " 0 " + std::to_string(level - 2) + " 0 0\n";
+  }
+  blocks += "4 1 0 0 0\n";
+  for (int level = 5; level <= 30; ++level) {
+    blocks += std::to_string(level) + " " + std::to_string(level + 25) + " 0 0 0\n";
+  }
+  blocks += "31 56 29 0 0\n";
+  Check(ParseMacrocell(blocks, &tree, &rule, &error), "distant blocks parse");
+  HashLifeEngine strip(tree, HashLifeOptions{});
+  Check(strip.Population() == 8 && !strip.ExportBoard(&exported, &error),
+        "a strip 2^31 cells wide is too wide to export");
+
+  // Multi-state leaves: only state 1 is alive, so the one cell in state 2 is dropped
+  Check(ParseMacrocell("[M2]\n#R B2/S/C3\n1 0 1 0 0\n1 0 0 0 1\n1 1 1 2 0\n2 0 1 0 0\n2 0 2 3 0\n3 4 0 5 0\n", &tree,
+                       &rule, &error) &&
+            rule == "B2/S/C3" && HashLifeEngine(tree, HashLifeOptions{}).Population() == 4,
+        "multi-state Macrocell keeps state 1 only");
+
+  for (const char* bad : {"x = 1", "[M2]\n4 1 0 0 0\n", "[M2]\n$$$$$$$$$*\n", "[M2]\n.........$\n"}) {
+    Check(!ParseMacrocell(bad, &tree, &rule, &error), "malformed Macrocell is rejected: " + std::string(bad));
+  }
+}
+
+// Live cells of `board` cropped to their bounding box, the way the unbounded engines export them
+Board CropToLiveCells(const Board& board) {
+  int minX = board.Width();
+  int minY = board.Height();
+  int maxX = -1;
+  int maxY = -1;
+  for (int y = 0; y < board.Height(); ++y) {
+    for (int x = 0; x < board.Width(); ++x) {
+      if (!board.Get(x, y)) continue;
+      minX = std::min(minX, x);
+      minY = std::min(minY, y);
+      maxX = std::max(maxX, x);
+      maxY = std::max(maxY, y);
+    }
+  }
+  return maxX < 0 ? Board() : PlaceBoard(board, maxX - minX + 1, maxY - minY + 1, -minX, -minY);
+}
+
+// Soups on the unbounded plane run alongside the packed engine on a torus wide enough that nothing wraps
+constexpr int kSoupSize = 128;
+constexpr uint64_t kUnboundedGenerations = 256;
+constexpr int kTorusMargin = kUnboundedGenerations + 8;
+constexpr int kTorusSize = kSoupSize + 2 * kTorusMargin;
+// Generations at which the engines are compared
+constexpr uint64_t kCheckpoints[] = {1, 2, 3, 32, 64, kUnboundedGenerations};
+
+// Compares an unbounded engine's window and exported cells with the torus
+void CheckAgainstTorus(Engine* engine, PackedEngine* torus, const std::string& name) {
+  std::string error;
+  Board exported;
+  Check(engine->Generation() == torus->Generation() && engine->Population() == torus->Population() &&
+            engine->View() == PlaceBoard(torus->View(), kSoupSize, kSoupSize, -kTorusMargin, -kTorusMargin) &&
+            engine->ExportBoard(&exported, &error) && exported == CropToLiveCells(torus->View()),
+        name + ", generation " + std::to_string(torus->Generation()));
+}
+
+void CheckHashLife() {
+  std::string error;
+  uint64_t seed = 800;
+  for (const char* ruleText : kTestRules) {
+    Rule rule;
+    ParseRule(ruleText, &rule, &error);
+    PackedEngineOptions options;
+    options.kernel = SelectKernel("")->ForRule(rule);
+    options.rule = rule;
+    const Board soup = RandomBoard(kSoupSize, kSoupSize, 0.4, seed++);
+    PackedEngine torus(PlaceBoard(soup, kTorusSize, kTorusSize, kTorusMargin, kTorusMargin), options);
+    HashLifeOptions hashLifeOptions;
+    hashLifeOptions.rule = rule;
+    HashLifeEngine stepped(soup, hashLifeOptions);
+    for (const uint64_t checkpoint : kCheckpoints) {
+      torus.Advance(checkpoint - torus.Generation());
+      stepped.Advance(checkpoint - stepped.Generation());
+      CheckAgainstTorus(&stepped, &torus, std::string("hashlife, ") + ruleText);
+    }
+
+    // With a one-byte budget the first evaluation already collects, and collections repeat whenever use doubles, all
+    // within the one jump
+    hashLifeOptions.memoryBudgetBytes = 1;
+    HashLifeEngine collected(soup, hashLifeOptions);
+    collected.AdvancePowerOfTwo(8);
+    CheckAgainstTorus(&collected, &torus, std::string("hashlife with a one-byte budget, ") + ruleText);
+    Check(collected.GarbageCollections() > 1, std::string("hashlife collects garbage during a jump, ") + ruleText);
+  }
+}
+
+void CheckSparse() {
+  std::string error;
+  uint64_t seed = 900;
+  for (const char* ruleText : kTestRules) {
+    Rule rule;
+    ParseRule(ruleText, &rule, &error);
+    PackedEngineOptions options;
+    options.kernel = SelectKernel("")->ForRule(rule);
+    options.rule = rule;
+    const Board soup = RandomBoard(kSoupSize, kSoupSize, 0.4, seed++);
+    PackedEngine torus(PlaceBoard(soup, kTorusSize, kTorusSize, kTorusMargin, kTorusMargin), options);
+    std::vector<std::unique_ptr<SparseEngine>> engines;
+    for (const StepKernel& kernel : AvailableKernels()) {
+      engines.push_back(std::make_unique<SparseEngine>(soup, SparseEngineOptions{kernel.ForRule(rule), rule}));
+    }
+    for (const uint64_t checkpoint : kCheckpoints) {
+      torus.Advance(checkpoint - torus.Generation());
+      for (size_t i = 0; i < engines.size(); ++i) {
+        engines[i]->Advance(checkpoint - engines[i]->Generation());
+        CheckAgainstTorus(engines[i].get(), &torus,
+                          std::string("sparse with the ") + AvailableKernels()[i].name + " kernel, " + ruleText);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  CheckStepKernels();
+  CheckPaddedRows();
+  CheckPackedEngine();
+  CheckGenerations();
+  CheckDensityPyramid();
+  CheckSimulationThread();
+  CheckImageImport();
+  CheckImageExport();
+  CheckLargerThanLife();
+  CheckRle();
+  CheckMacrocell();
+  CheckHashLife();
+  CheckSparse();
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::fprintf(stderr, "all checks passed\n");
+  return 0;
+}
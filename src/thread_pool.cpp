@@ -0,0 +1,65 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threadCount) {
+  for (int i = 1; i < threadCount; ++i) workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  startCondition_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+}
+
+void ThreadPool::Run(const std::function<void(int)>& task) {
+  if (workers_.empty()) {
+    task(0);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    pending_ = static_cast<int>(workers_.size());
+    ++batch_;
+  }
+  startCondition_.notify_all();
+  task(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  doneCondition_.wait(lock, [this] { return pending_ == 0; });
+  task_ = nullptr;
+}
+
+void ThreadPool::RunRanges(int count, const std::function<void(int, int)>& task) {
+  const int workers = ThreadCount();
+  Run([&](int worker) {
+    const int begin = static_cast<int>(static_cast<int64_t>(count) * worker / workers);
+    const int end = static_cast<int>(static_cast<int64_t>(count) * (worker + 1) / workers);
+    if (begin < end) task(begin, end);
+  });
+}
+
+int ThreadPool::DefaultThreadCount() {
+  const unsigned int count = std::thread::hardware_concurrency();
+  return count == 0 ? 1 : static_cast<int>(count);
+}
+
+void ThreadPool::WorkerLoop(int workerIndex) {
+  uint64_t seenBatch = 0;
+  while (true) {
+    const std::function<void(int)>* task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      startCondition_.wait(lock, [&] { return stopping_ || batch_ != seenBatch; });
+      if (stopping_) return;
+      seenBatch = batch_;
+      task = task_;
+    }
+    (*task)(workerIndex);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) doneCondition_.notify_one();
+    }
+  }
+}
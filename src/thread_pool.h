@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads created once and reused for every generation. Run() hands the same task to every
+// worker and blocks until all of them have finished it, which doubles as the barrier before the engine swaps boards.
+// The calling thread takes part as worker 0, so a pool of N threads only spawns N - 1.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int threadCount);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int ThreadCount() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Runs task(workerIndex) once on each worker, workerIndex in [0, ThreadCount())
+  void Run(const std::function<void(int)>& task);
+  // Splits [0, count) into one contiguous, nearly equal range per worker and runs task(begin, end) on each nonempty one
+  void RunRanges(int count, const std::function<void(int, int)>& task);
+
+  // hardware_concurrency(), or 1 when the platform cannot tell
+  static int DefaultThreadCount();
+
+ private:
+  void WorkerLoop(int workerIndex);
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable startCondition_;
+  std::condition_variable doneCondition_;
+  const std::function<void(int)>* task_ = nullptr;
+  uint64_t batch_ = 0;
+  int pending_ = 0;
+  bool stopping_ = false;
+};
@@ -0,0 +1,62 @@
+#include "tile_scheduler.h"
+
+TileScheduler::TileScheduler(int workerCount) : stats_(workerCount) {
+  for (int i = 0; i < workerCount; ++i) queues_.push_back(std::make_unique<WorkerQueue>());
+}
+
+void TileScheduler::Run(ThreadPool* pool, int tileCount, const std::function<void(int)>& processTile) {
+  const int workers = static_cast<int>(queues_.size());
+  for (int worker = 0; worker < workers; ++worker) {
+    const int begin = static_cast<int>(static_cast<int64_t>(tileCount) * worker / workers);
+    const int end = static_cast<int>(static_cast<int64_t>(tileCount) * (worker + 1) / workers);
+    std::deque<int>& tiles = queues_[worker]->tiles;
+    tiles.clear();
+    // Pushed in reverse so the owner, popping from the back, walks its block in board order
+    for (int tile = end - 1; tile >= begin; --tile) tiles.push_back(tile);
+  }
+  if (pool == nullptr) {
+    WorkerLoop(0, processTile);
+  } else {
+    pool->Run([this, &processTile](int worker) { WorkerLoop(worker, processTile); });
+  }
+}
+
+void TileScheduler::ResetStats() { stats_.assign(stats_.size(), WorkerStats{}); }
+
+bool TileScheduler::PopOwn(int worker, int* tile) {
+  WorkerQueue& queue = *queues_[worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tiles.empty()) return false;
+  *tile = queue.tiles.back();
+  queue.tiles.pop_back();
+  return true;
+}
+
+bool TileScheduler::Steal(int thief, int* tile) {
+  const int workers = static_cast<int>(queues_.size());
+  for (int offset = 1; offset < workers; ++offset) {
+    WorkerQueue& victim = *queues_[(thief + offset) % workers];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (victim.tiles.empty()) continue;
+    // Take from the far end of the victim's block, away from where its owner is working
+    *tile = victim.tiles.front();
+    victim.tiles.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void TileScheduler::WorkerLoop(int worker, const std::function<void(int)>& processTile) {
+  WorkerStats& stats = stats_[worker];
+  int tile;
+  while (PopOwn(worker, &tile)) {
+    processTile(tile);
+    ++stats.tilesProcessed;
+  }
+  // No tiles are added during a run, so once every deque is empty there is nothing left to wait for
+  while (Steal(worker, &tile)) {
+    processTile(tile);
+    ++stats.tilesProcessed;
+    ++stats.tilesStolen;
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "thread_pool.h"
+
+// Per-worker counters accumulated across every Run() since construction or the last ResetStats(). Cache-line aligned
+// so workers bumping their own counters do not contend.
+struct alignas(64) WorkerStats {
+  uint64_t tilesProcessed = 0;
+  uint64_t tilesStolen = 0;
+};
+
+// Hands out tile indices to a thread pool through one deque per worker. Each worker starts with a contiguous block of
+// tiles, works through its own deque from the back and, once that is empty, steals from the front of the other
+// workers' deques, so a worker that drew cheap tiles helps out instead of waiting at the barrier.
+class TileScheduler {
+ public:
+  explicit TileScheduler(int workerCount);
+
+  // Calls processTile(tile) exactly once for every tile in [0, tileCount) and returns when all are done
+  void Run(ThreadPool* pool, int tileCount, const std::function<void(int)>& processTile);
+
+  const std::vector<WorkerStats>& Stats() const { return stats_; }
+  void ResetStats();
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<int> tiles;
+  };
+
+  bool PopOwn(int worker, int* tile);
+  bool Steal(int thief, int* tile);
+  void WorkerLoop(int worker, const std::function<void(int)>& processTile);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<WorkerStats> stats_;
+};
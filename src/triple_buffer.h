@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Single-producer, single-consumer handoff of whole values without locks. The producer fills Back() and calls
+// Publish(); the consumer calls Update() and then reads Front(). Neither side ever waits for the other: publishing
+// swaps the back slot with a shared middle slot through one atomic exchange, and the consumer swaps the middle slot
+// into the front only when something new was published since its last look. Values that are published but never
+// picked up are simply overwritten by the next one.
+template <class T>
+class TripleBuffer {
+ public:
+  explicit TripleBuffer(const T& initial) : slots_{initial, initial, initial} {}
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  // Producer side
+  T& Back() { return slots_[back_]; }
+  // Which of the three slots Back() is, for producers that keep their own state per slot
+  int BackIndex() const { return back_; }
+  void Publish() { back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndexMask; }
+
+  // Consumer side. Returns whether Front() changed.
+  bool Update() {
+    if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+  const T& Front() const { return slots_[front_]; }
+
+ private:
+  static constexpr int kIndexMask = 3;
+  static constexpr int kFresh = 4;
+
+  std::array<T, 3> slots_;
+  // Each index is owned by one side (the middle one by both), so keep them on separate cache lines
+  alignas(64) int back_ = 0;
+  alignas(64) std::atomic<int> middle_{1};
+  alignas(64) int front_ = 2;
+};
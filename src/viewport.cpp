@@ -0,0 +1,49 @@
+#include "viewport.h"
+
+#include <algorithm>
+#include <cmath>
+
+Viewport::Viewport(int screenWidth, int screenHeight, int boardWidth, int boardHeight)
+    : screenWidth_(screenWidth),
+      screenHeight_(screenHeight),
+      boardWidth_(std::max(boardWidth, 1)),
+      boardHeight_(std::max(boardHeight, 1)) {
+  const float fitZoom = std::min(static_cast<float>(screenWidth_) / static_cast<float>(boardWidth_),
+                                 static_cast<float>(screenHeight_) / static_cast<float>(boardHeight_));
+  // Zooming out further than the whole board at a quarter of the window only shrinks it to nothing
+  minZoom_ = std::min(fitZoom / 4, 1.0f);
+  Fit();
+}
+
+void Viewport::Fit() {
+  zoom_ = std::clamp(std::min(static_cast<float>(screenWidth_) / static_cast<float>(boardWidth_),
+                              static_cast<float>(screenHeight_) / static_cast<float>(boardHeight_)),
+                     minZoom_, kMaxZoom);
+  origin_ = {(static_cast<float>(boardWidth_) - static_cast<float>(screenWidth_) / zoom_) / 2,
+             (static_cast<float>(boardHeight_) - static_cast<float>(screenHeight_) / zoom_) / 2};
+}
+
+void Viewport::Pan(Vector2 screenDelta) {
+  origin_.x -= screenDelta.x / zoom_;
+  origin_.y -= screenDelta.y / zoom_;
+  Clamp();
+}
+
+void Viewport::ZoomAt(float factor, Vector2 screenPoint) {
+  const Vector2 anchor{origin_.x + screenPoint.x / zoom_, origin_.y + screenPoint.y / zoom_};
+  zoom_ = std::clamp(zoom_ * factor, minZoom_, kMaxZoom);
+  origin_ = {anchor.x - screenPoint.x / zoom_, anchor.y - screenPoint.y / zoom_};
+  Clamp();
+}
+
+int Viewport::DetailLevel() const {
+  if (zoom_ >= 1.0f) return 0;
+  return static_cast<int>(std::ceil(std::log2(1.0f / zoom_) - 1e-4f));
+}
+
+void Viewport::Clamp() {
+  const float visibleWidth = static_cast<float>(screenWidth_) / zoom_;
+  const float visibleHeight = static_cast<float>(screenHeight_) / zoom_;
+  origin_.x = std::clamp(origin_.x, -visibleWidth / 2, static_cast<float>(boardWidth_) - visibleWidth / 2);
+  origin_.y = std::clamp(origin_.y, -visibleHeight / 2, static_cast<float>(boardHeight_) - visibleHeight / 2);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "raylib.h"
+
+// Camera over the board: which cells the window shows and how large. The zoom is in screen pixels per cell, and the
+// board point at the window's top-left corner is the origin.
+class Viewport {
+ public:
+  static constexpr float kMaxZoom = 64.0f;
+
+  Viewport(int screenWidth, int screenHeight, int boardWidth, int boardHeight);
+
+  // Shows the whole board, centred
+  void Fit();
+  // Moves the view by a distance in screen pixels, as when dragging the board
+  void Pan(Vector2 screenDelta);
+  // Scales the zoom by `factor`, keeping the cell under `screenPoint` in place
+  void ZoomAt(float factor, Vector2 screenPoint);
+
+  int ScreenWidth() const { return screenWidth_; }
+  int ScreenHeight() const { return screenHeight_; }
+  int BoardWidth() const { return boardWidth_; }
+  int BoardHeight() const { return boardHeight_; }
+  float Zoom() const { return zoom_; }
+  Vector2 Origin() const { return origin_; }
+
+  // Level of detail to draw at: each texel covers 2^level x 2^level cells, the smallest power of two no smaller than
+  // the cells per screen pixel, so a frame never needs more texels than the window has pixels
+  int DetailLevel() const;
+
+ private:
+  // Keeps at least part of the board on screen
+  void Clamp();
+
+  int screenWidth_;
+  int screenHeight_;
+  int boardWidth_;
+  int boardHeight_;
+  float minZoom_ = 1.0f;
+  float zoom_ = 1.0f;
+  Vector2 origin_{0, 0};
+};